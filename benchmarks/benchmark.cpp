@@ -0,0 +1,321 @@
+// Benchmark of the read/write paths of "H5p::File", under realistic workloads.
+//
+// Each workload is run for a sweep of sizes, in each of the directories (e.g. a tmpfs and a disk),
+// and reported as one line of CSV (see "--help"):
+//
+//   workload,dir,size,ops,bytes,seconds,ops_per_s,MB_per_s,p50_us,p99_us
+//
+// - "size" : the parameter of the sweep (entries, datasets, or depth; see below)
+// - "ops"  : number of timed operations, the latencies "p50_us" and "p99_us" are per operation
+// - "seconds", "ops_per_s", and "MB_per_s" include closing the file (that writes buffered data)
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#ifdef HDF5PP_XTENSOR
+#include <xtensor/xarray.hpp>
+#include <xtensor/xbuilder.hpp>
+#endif
+
+#include <HDF5pp.h>
+
+// ============================================ TIMING =============================================
+
+using Clock = std::chrono::steady_clock;
+
+// latencies of the operations of one run [seconds]
+
+class Timer
+{
+public:
+
+  Timer(size_t n) { m_lap.reserve(n); m_start = Clock::now(); m_last = m_start; }
+
+  // end of an operation
+  void lap()
+  {
+    Clock::time_point now = Clock::now();
+    m_lap.push_back(std::chrono::duration<double>(now - m_last).count());
+    m_last = now;
+  }
+
+  // end of the run, after the last operation (e.g. closing the file)
+  void stop() { m_last = Clock::now(); }
+
+  // total time
+  double total() const { return std::chrono::duration<double>(m_last - m_start).count(); }
+
+  // percentile "p" (in [0,100]) of the latencies
+  double percentile(double p) const
+  {
+    if ( m_lap.size() == 0 ) return 0.0;
+
+    std::vector<double> lap = m_lap;
+
+    size_t i = static_cast<size_t>(p / 100.0 * static_cast<double>(lap.size() - 1) + 0.5);
+
+    std::nth_element(lap.begin(), lap.begin() + i, lap.end());
+
+    return lap[i];
+  }
+
+  size_t size() const { return m_lap.size(); }
+
+private:
+
+  std::vector<double> m_lap;
+  Clock::time_point   m_start;
+  Clock::time_point   m_last;
+};
+
+// ============================================ OUTPUT =============================================
+
+// write the result of one run
+
+void report(const std::string &workload, const std::string &dir, size_t size, size_t bytes,
+  const Timer &timer)
+{
+  double t = timer.total();
+
+  std::cout
+    << workload                                   << ","
+    << dir                                        << ","
+    << size                                       << ","
+    << timer.size()                               << ","
+    << bytes                                      << ","
+    << t                                          << ","
+    << ( t > 0 ? timer.size() / t : 0.0 )         << ","
+    << ( t > 0 ? bytes / t / 1.0e6 : 0.0 )        << ","
+    << timer.percentile(50.0) * 1.0e6             << ","
+    << timer.percentile(99.0) * 1.0e6             << std::endl;
+}
+
+// ========================================== WORKLOADS ============================================
+
+// scalar append path: "write(path, value, index)" for "n" consecutive indices
+
+void scalar_append(const std::string &dir, const std::string &fname, size_t n)
+{
+  Timer timer(n);
+
+  {
+    H5p::File file(fname, "w");
+
+    for ( size_t i = 0 ; i < n ; ++i )
+    {
+      file.write("/scalar", static_cast<double>(i), i);
+      timer.lap();
+    }
+  }
+
+  timer.stop();
+
+  report("scalar_append", dir, n, n * sizeof(double), timer);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// many small datasets: "n" vectors of 16 entries, in groups of 100 datasets
+
+void many_small(const std::string &dir, const std::string &fname, size_t n)
+{
+  std::vector<double> data(16, 1.0);
+
+  Timer timer(n);
+
+  {
+    H5p::File file(fname, "w");
+
+    for ( size_t i = 0 ; i < n ; ++i )
+    {
+      file.write("/group"+std::to_string(i/100)+"/data"+std::to_string(i), data);
+      timer.lap();
+    }
+  }
+
+  timer.stop();
+
+  report("many_small", dir, n, n * data.size() * sizeof(double), timer);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// large contiguous array of "n" entries: written (to a new file) and read, "repeat" times
+
+void large_array(const std::string &dir, const std::string &fname, size_t n, size_t repeat)
+{
+  std::vector<double> data(n, 1.0);
+
+  Timer write(repeat);
+
+  for ( size_t r = 0 ; r < repeat ; ++r )
+  {
+    H5p::File file(fname, "w");
+    file.write("/data", data);
+    file.flush();
+    write.lap();
+  }
+
+  report("large_write", dir, n, repeat * n * sizeof(double), write);
+
+  H5p::File file(fname, "r");
+
+  Timer read(repeat);
+
+  for ( size_t r = 0 ; r < repeat ; ++r )
+  {
+    file.read_into("/data", data);
+    read.lap();
+  }
+
+  report("large_read", dir, n, repeat * n * sizeof(double), read);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// "exists" in a hierarchy of "depth" nested groups: "n" queries of existing and missing paths
+// (in a file that is re-opened, such that nothing is known about the hierarchy)
+
+void exists_deep(const std::string &dir, const std::string &fname, size_t depth, size_t n)
+{
+  std::string path;
+
+  for ( size_t i = 0 ; i < depth ; ++i ) path += "/g" + std::to_string(i);
+
+  {
+    H5p::File file(fname, "w");
+    file.write(path + "/data", 1.0);
+  }
+
+  H5p::File file(fname, "r");
+
+  Timer timer(n);
+
+  size_t found = 0;
+
+  for ( size_t i = 0 ; i < n ; ++i )
+  {
+    found += file.exists(i % 2 == 0 ? path + "/data" : path + "/missing") ? 1 : 0;
+    timer.lap();
+  }
+
+  if ( found != (n + 1) / 2 ) throw std::runtime_error("exists_deep: unexpected result");
+
+  report("exists_deep", dir, depth, 0, timer);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// xtensor expression of "n" entries written to a new dataset, "repeat" times
+
+#ifdef HDF5PP_XTENSOR
+
+void xtensor_expression(const std::string &dir, const std::string &fname, size_t n, size_t repeat)
+{
+  xt::xarray<double> a = xt::ones<double>({n});
+  xt::xarray<double> b = xt::ones<double>({n});
+
+  Timer timer(repeat);
+
+  {
+    H5p::File file(fname, "w");
+
+    for ( size_t r = 0 ; r < repeat ; ++r )
+    {
+      file.write("/data" + std::to_string(r), a + 2.0 * b);
+      timer.lap();
+    }
+  }
+
+  timer.stop();
+
+  report("xtensor_expression", dir, n, repeat * n * sizeof(double), timer);
+}
+
+#endif
+
+// ============================================= MAIN ==============================================
+
+void usage()
+{
+  std::cerr
+    << "Usage: benchmark [options]\n"
+    << "\n"
+    << "Options:\n"
+    << "  --dir DIR    Directory to run in (repeatable), default: /dev/shm (tmpfs) and .\n"
+    << "  --repeat N   Repetitions of the large-array workloads (default: 10)\n"
+    << "  --quick      Only the smallest size of each sweep (e.g. as a smoke test)\n"
+    << "  --help       Show this help\n"
+    << "\n"
+    << "Output (CSV, on stdout):\n"
+    << "  workload,dir,size,ops,bytes,seconds,ops_per_s,MB_per_s,p50_us,p99_us\n";
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  // parse options
+  std::vector<std::string> dirs;
+  size_t repeat = 10;
+  bool   quick  = false;
+
+  for ( int i = 1 ; i < argc ; ++i )
+  {
+    std::string arg = argv[i];
+
+    if      ( arg == "--dir"    && i + 1 < argc ) dirs.push_back(argv[++i]);
+    else if ( arg == "--repeat" && i + 1 < argc ) repeat = std::stoul(argv[++i]);
+    else if ( arg == "--quick"                  ) quick = true;
+    else { usage(); return arg == "--help" ? 0 : 1; }
+  }
+
+  if ( dirs.size() == 0 ) dirs = {"/dev/shm", "."};
+
+  // sweeps
+  std::vector<size_t> n_scalar = {1000, 10000, 100000};
+  std::vector<size_t> n_small  = {100, 1000, 10000};
+  std::vector<size_t> n_large  = {131072, 2097152, 16777216}; // 1MB, 16MB, 128MB of doubles
+  std::vector<size_t> n_depth  = {4, 16, 64};
+
+  if ( quick )
+  {
+    n_scalar.resize(1);
+    n_small .resize(1);
+    n_large .resize(1);
+    n_depth .resize(1);
+  }
+
+  std::cout << "workload,dir,size,ops,bytes,seconds,ops_per_s,MB_per_s,p50_us,p99_us" << std::endl;
+
+  for ( auto &dir : dirs )
+  {
+    std::string fname = dir + "/HDF5pp-benchmark.h5";
+
+    // skip directories that cannot be written
+    if ( ! std::ofstream(fname) )
+    {
+      std::cerr << "benchmark: skipping '" << dir << "' (not writable)" << std::endl;
+      continue;
+    }
+
+    for ( auto &n : n_scalar ) scalar_append(dir, fname, n);
+    for ( auto &n : n_small  ) many_small   (dir, fname, n);
+    for ( auto &n : n_large  ) large_array  (dir, fname, n, repeat);
+    for ( auto &n : n_depth  ) exists_deep  (dir, fname, n, 10000);
+
+    #ifdef HDF5PP_XTENSOR
+    for ( auto &n : n_large  ) xtensor_expression(dir, fname, n, repeat);
+    #endif
+
+    std::remove(fname.c_str());
+  }
+
+  return 0;
+}
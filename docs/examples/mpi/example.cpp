@@ -0,0 +1,33 @@
+#include <iostream>
+
+#define HDF5PP_MPI
+
+#include <HDF5pp.h>
+
+int main(int argc, char **argv)
+{
+  MPI_Init(&argc, &argv);
+
+  // rank of this process, number of processes
+  int rank, size;
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  // NB the file has to be closed before "MPI_Finalize"
+  {
+    // open file, by all processes
+    H5p::File file = H5p::File("example.hdf5", "w", MPI_COMM_WORLD);
+
+    // some example data: one row per process
+    std::vector<double> data(10, static_cast<double>(rank));
+
+    // write the row of this process to the array of shape (size, 10), collectively
+    file.write_slice("/data", data.data(), H5::PredType::NATIVE_DOUBLE,
+      {static_cast<size_t>(size), 10}, {static_cast<size_t>(rank), 0}, {1, 10});
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}
@@ -15,6 +15,10 @@ int main()
   // write data
   file.write("/data", data, shape);
 
+  // write (and overwrite) data as a flat array, of a braced shape
+  file.write    ("/flat", data, {6});
+  file.overwrite("/flat", data, {6});
+
   // read data
   std::vector<double> read_data = file.read<std::vector<double>>("/data");
 
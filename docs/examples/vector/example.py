@@ -5,3 +5,4 @@ import numpy as np
 f = h5py.File('example.hdf5','r')
 
 print(f['/data'][...])
+print(f['/flat'][...])
@@ -15,6 +15,28 @@
 #include <fstream>
 #include "H5Cpp.h"
 #include <vector>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <atomic>
 #include <assert.h>
 
 // optionally enable plug-in Eigen and load the library
@@ -47,10 +69,49 @@
 #include <xtensor/xfixed.hpp>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xeval.hpp>
+#include <xtensor/xview.hpp>
 #include <xtensor/xexpression.hpp>
 #include <xtensor/xio.hpp>
 #endif
 
+// optionally enable plug-in MPI (parallel HDF5), by "#define HDF5PP_MPI" before including this file
+// NB requires an HDF5 library that is compiled with parallel support
+
+#ifdef HDF5PP_MPI
+#ifndef H5_HAVE_PARALLEL
+#error "HDF5pp: HDF5PP_MPI requires an HDF5 library with parallel support"
+#endif
+#include <mpi.h>
+#endif
+
+// optionally enable multi-threaded (de)compression of chunks (deflate), using zlib directly
+// NB requires HDF5 >= 1.10.5 (direct chunk I/O), see "File::setThreads"
+
+#ifdef ZLIB_VERSION
+#define HDF5PP_ZLIB
+#endif
+
+#ifdef HDF5PP_ZLIB
+#include <zlib.h>
+#include <atomic>
+#if !H5_VERSION_GE(1,10,5)
+#error "HDF5pp: HDF5PP_ZLIB requires HDF5 >= 1.10.5"
+#endif
+#endif
+
+// memory-mapped reads of contiguous datasets (POSIX), see "File::map"
+// reads of an ensemble of files by a pool of processes (POSIX), see "Ensemble"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HDF5PP_MMAP
+#define HDF5PP_FORK
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
 // -------------------------------------- version information --------------------------------------
 
 #define HDF5PP_WORLD_VERSION 0
@@ -73,16 +134,684 @@ namespace H5p {
 
 // ======================================= SUPPORT FUNCTIONS =======================================
 
-template<typename T> inline H5::PredType getType();
+// registry that maps a C++ type to its HDF5 (native) data-type, used by all read/write functions
+// - integers (signed and unsigned, of 1, 2, 4, or 8 bytes), "float", "double", "long double"
+// - "bool": enumeration "FALSE = 0, TRUE = 1" of 8-bit integers (as h5py)
+// - "std::complex<T>": compound of members "r" and "i" (as h5py)
+// NB to add a type, specialize "TypeTraits" deriving from "std::true_type", with a function
+//    "type()" that returns the (native) data-type
+template<typename T, typename = void>
+struct TypeTraits : std::false_type {};
+
+template<typename T>
+struct TypeTraits<T, typename std::enable_if<
+  std::is_integral<T>::value && ! std::is_same<T,bool>::value>::type> : std::true_type
+{
+  static const H5::PredType& type()
+  {
+    const bool sign = std::is_signed<T>::value;
+
+    switch ( sizeof(T) )
+    {
+      case 1 : return sign ? H5::PredType::NATIVE_INT8  : H5::PredType::NATIVE_UINT8;
+      case 2 : return sign ? H5::PredType::NATIVE_INT16 : H5::PredType::NATIVE_UINT16;
+      case 4 : return sign ? H5::PredType::NATIVE_INT32 : H5::PredType::NATIVE_UINT32;
+      default: return sign ? H5::PredType::NATIVE_INT64 : H5::PredType::NATIVE_UINT64;
+    }
+  }
+};
+
+template<> struct TypeTraits<float> : std::true_type
+{
+  static const H5::PredType& type() { return H5::PredType::NATIVE_FLOAT; }
+};
+
+template<> struct TypeTraits<double> : std::true_type
+{
+  static const H5::PredType& type() { return H5::PredType::NATIVE_DOUBLE; }
+};
+
+template<> struct TypeTraits<long double> : std::true_type
+{
+  static const H5::PredType& type() { return H5::PredType::NATIVE_LDOUBLE; }
+};
+
+template<> struct TypeTraits<bool> : std::true_type
+{
+  static H5::DataType type()
+  {
+    static_assert(sizeof(bool) == 1, "HDF5pp: 'bool' is expected to be stored in 1 byte");
+
+    H5::EnumType out(H5::PredType::NATIVE_INT8);
+
+    int8_t value = 0; out.insert("FALSE", &value);
+    value        = 1; out.insert("TRUE" , &value);
+
+    return out;
+  }
+};
+
+template<typename T>
+struct TypeTraits<std::complex<T>, typename std::enable_if<
+  std::is_floating_point<T>::value>::type> : std::true_type
+{
+  static H5::DataType type()
+  {
+    H5::CompType out(sizeof(std::complex<T>));
+
+    out.insertMember("r", 0        , TypeTraits<T>::type());
+    out.insertMember("i", sizeof(T), TypeTraits<T>::type());
+
+    return out;
+  }
+};
+
+// "std::vector", excluded from the overloads for a scalar of arbitrary type (such that e.g.
+// "write(path, data, {n})" selects the overload with a shape, and not an "H5::DataType")
+template<typename T>
+struct IsVector : std::false_type {};
+
+template<typename T, typename A>
+struct IsVector<std::vector<T,A>> : std::true_type {};
+
+// HDF5 (native) data-type of a registered C++ type (see "TypeTraits")
+template<typename T>
+inline decltype(auto) getType()
+{
+  static_assert(TypeTraits<T>::value, "HDF5pp: unsupported type, see 'H5p::TypeTraits'");
+
+  return TypeTraits<T>::type();
+}
+
+// (internal) data-type in the file: integers and floating-point numbers are stored little-endian
+inline H5::DataType fileType(const H5::DataType &type)
+{
+  H5::DataType out;
+
+  out.copy(type);
+
+  if ( out.getClass() == H5T_INTEGER || out.getClass() == H5T_FLOAT )
+    H5Tset_order(out.getId(), H5T_ORDER_LE);
+
+  return out;
+}
+
+// (internal) call "fn" with the entries of a tuple as arguments
+template<class Fn, class Tuple, size_t... I>
+inline void applyTuple(Fn &fn, Tuple &args, std::index_sequence<I...>)
+{
+  fn(std::get<I>(args)...);
+}
+
+// chunk shape for a dataset of a certain shape and item size: chunks of about 8kB-1MB, that
+// are (close to) proportional to the shape of the dataset
+inline std::vector<hsize_t> autoChunk(const std::vector<size_t> &shape, size_t itemsize);
+
+// ========================================= FLUSH POLICY ==========================================
+
+// when the file is flushed after a write operation, construct using one of the named constructors:
+// - "always"            : after each write (default)
+// - "never"             : only on an explicit "flush()"
+// - "every(n)"          : after every "n" writes
+// - "interval(seconds)" : after the first write that is at least "seconds" after the last flush
+// - "bytes(n)"          : after the first write that brings the number of unflushed bytes to "n"
+// - "checkpoint"        : only on an explicit "flush()" or "checkpoint()"
+
+struct FlushPolicy
+{
+  enum Mode { Always, Never, Writes, Seconds, Bytes, Checkpoint };
+
+  Mode   mode;
+  double threshold; // number of writes, number of seconds, or number of bytes
+
+  static FlushPolicy always()                 { return FlushPolicy{Always    , 0.0    }; }
+  static FlushPolicy never()                  { return FlushPolicy{Never     , 0.0    }; }
+  static FlushPolicy every(size_t n)          { return FlushPolicy{Writes    , 1.0*n  }; }
+  static FlushPolicy interval(double seconds) { return FlushPolicy{Seconds   , seconds}; }
+  static FlushPolicy bytes(size_t n)          { return FlushPolicy{Bytes     , 1.0*n  }; }
+  static FlushPolicy checkpoint()             { return FlushPolicy{Checkpoint, 0.0    }; }
+};
+
+// counters of write and flush operations (since opening the file)
+
+struct FlushStats
+{
+  size_t writes=0;  // number of write operations
+  size_t bytes=0;   // number of bytes written
+  size_t flushes=0; // number of flushes
+  double time=0.0;  // time spent flushing [seconds]
+};
+
+// =================================== DATASET CREATION OPTIONS ====================================
+
+// size along an axis that can be extended without bounds, see "DataSetOptions::max_shape"
+const size_t unlimited = static_cast<size_t>(H5S_UNLIMITED);
+
+// storage of array datasets, default: contiguous and uncompressed
+// NB an array with a maximum shape (an extendable array) requires chunked storage
+// NB filters require chunked storage, if "chunk" is empty the chunk shape is set by "autoChunk"
+// NB scalar datasets are never chunked (nor filtered)
+// NB datasets that are not chunked, of at most "compact" bytes, are stored in their object header
+//    (compact layout): this saves space and time for scalars and small arrays; it is not used in a
+//    parallel (MPI) file, as compact data is metadata that collective writes may not reach
+// NB "storage" is the data-type in the file, if it differs from that of the data (e.g. to store
+//    doubles as "H5::PredType::NATIVE_FLOAT"): HDF5 converts when writing and reading; it only
+//    applies to data of the same class (e.g. floating-point data if "storage" is a float)
+// NB "scale_offset" quantizes floating-point data to "scale_offset" decimal digits (lossy), and
+//    stores integers using the minimal number of bits (lossless if 0: computed automatically)
+
+struct DataSetOptions
+{
+  std::vector<size_t>   max_shape;              // maximum shape, "unlimited" along extendable axes
+  std::vector<size_t>   chunk;                  // chunk shape (empty: automatic, if needed)
+  unsigned              deflate=0;              // deflate (gzip) level [1..9] (0: off)
+  bool                  shuffle=false;          // shuffle bytes before compression
+  unsigned              szip=0;                 // szip pixels per block [2,4,...,32] (0: off)
+  bool                  fletcher32=false;       // store checksum
+  H5Z_filter_t          filter=H5Z_FILTER_NONE; // filter plugin, e.g. LZ4 == 32004
+  std::vector<unsigned> filter_values;          // parameters of the filter plugin
+  size_t                compact=1024;           // maximum size of compact datasets [bytes] (0: off)
+  H5::DataType          storage;                // data-type in the file (default: that of the data)
+  int                   scale_offset=-1;        // scale-offset: decimal digits, or bits (-1: off)
+
+  // check if chunked storage is needed
+  bool chunked() const;
+
+  // (advanced) data-type in the file, for data of data-type "type" (little-endian)
+  H5::DataType storageType(const H5::DataType &type) const;
+
+  // (advanced) set the filters in a dataset creation property list, the data-type in the file
+  // "type" selects the scale-offset filter (if it is not specified, the filter is not set)
+  void setFilters(H5::DSetCreatPropList &plist, const H5::DataType &type=H5::DataType()) const;
+
+  // (advanced) dataset creation property list for a dataset of a specific shape and item size,
+  // and data-type in the file "type"
+  H5::DSetCreatPropList plist(const std::vector<size_t> &shape, size_t itemsize,
+    const H5::DataType &type=H5::DataType()) const;
+};
+
+// ====================================== ASYNCHRONOUS WRITER ======================================
+
+// (internal) background thread that executes write operations one-by-one, in the order in which
+// they are submitted (the HDF5 library is not thread-safe), see "File::setAsync"
+// NB at most "max_pending" operations are queued, "push" blocks until there is space
+
+class AsyncWriter
+{
+public:
+
+  AsyncWriter(size_t max_pending);
+
+  // wait for all operations to finish, stop the thread
+  ~AsyncWriter();
+
+  // submit an operation, the returned future holds its exception (if any)
+  std::future<void> push(std::function<void()> fn);
+
+  // wait for all submitted operations to finish
+  void wait();
+
+  // rethrow (and clear) the exception of the first operation that failed (if any)
+  void rethrow();
+
+  // check if the caller is the background thread
+  bool isWorker() const;
+
+private:
+
+  // execute the queue, until stopped
+  void run();
+
+  std::mutex                        m_mutex;
+  std::condition_variable           m_queued;       // notified when an operation is queued
+  std::condition_variable           m_done;         // notified when an operation is finished
+  std::deque<std::function<void()>> m_queue;
+  size_t                            m_max_pending;
+  bool                              m_busy=false;   // an operation is being executed
+  bool                              m_stop=false;
+  std::exception_ptr                m_error;        // exception of the first failed operation
+  std::thread                       m_thread;       // NB last: started when all else is set
+};
+
+// ============================= MULTI-THREADED CHUNK (DE)COMPRESSION ==============================
+
+#ifdef HDF5PP_ZLIB
+
+// (internal) chunked dataset whose filters ("deflate" and/or "shuffle") can be applied by HDF5pp,
+// such that chunks can be read/written raw and (de)compressed by several threads
+struct ChunkPipeline
+{
+  std::vector<hsize_t>      shape;   // shape of the dataset
+  std::vector<hsize_t>      chunk;   // shape of a chunk
+  size_t                    itemsize;
+  std::vector<H5Z_filter_t> filters; // filters, in the order in which they are applied on write
+  std::vector<int>          level;   // deflate level of each filter
+};
+
+// (internal) (un)shuffle the bytes of the items in a buffer, as the HDF5 shuffle filter
+inline std::vector<char> shuffleBytes(const std::vector<char> &data, size_t itemsize, bool shuffle);
+
+// (internal) copy the part of a chunk (at "offset") that lies within the dataset, between the
+// chunk and the (row-major) buffer of the entire dataset: to "data" or to "chunk"
+inline void copyChunk(char *data, char *chunk, const ChunkPipeline &pipe,
+  const std::vector<hsize_t> &offset, bool to_data);
+
+// (internal) apply the filters to a chunk, or undo them (skipping filters set in "mask")
+inline std::vector<char> encodeChunk(std::vector<char> data, const ChunkPipeline &pipe);
+inline std::vector<char> decodeChunk(std::vector<char> data, const ChunkPipeline &pipe,
+  uint32_t mask);
+
+#endif
+
+// ======================================== MAPPED DATASET =========================================
+
+// read-only view of the data of a dataset, see "File::map": the file is memory-mapped (such that
+// only the parts that are accessed are read from the file), or the data is read (if mapping is not
+// possible); the data is row-major of shape "shape()"
+// NB the view remains valid when the "File" is closed, but may not be used once the file is
+//    modified by another program
+
+template<typename T>
+class Mapped
+{
+public:
+
+  Mapped() = default;
+
+  // data
+  const T* data() const;
+  const T* begin() const;
+  const T* end() const;
+
+  const T& operator[](size_t i) const;
+
+  // shape, and number of entries
+  std::vector<size_t> shape() const;
+  size_t size() const;
+
+  // check if the file is memory-mapped, or the data was read
+  bool mapped() const;
+
+  #ifdef HDF5PP_XTENSOR
+  // read-only "xt::adapt" of the data, of shape "shape()" (valid as long as this object exists)
+  auto xview() const;
+  #endif
+
+private:
+
+  friend class File;
+
+  std::shared_ptr<const void> m_region;       // mapped region, or buffer with the data
+  const T*                    m_data=nullptr;
+  size_t                      m_size=0;
+  std::vector<size_t>         m_shape;
+  bool                        m_mapped=false;
+};
+
+// ====================================== BLOCKS OF A DATASET ======================================
+
+// block of rows of a dataset (along the first axis), see "File::iterate"
+
+template<typename T>
+struct Block
+{
+  const T*            data=nullptr; // entries (row-major) of shape "shape"
+  size_t              start=0;      // index of the first row
+  size_t              rows=0;       // number of rows (the last block may be smaller)
+  std::vector<size_t> shape;        // "{rows, ...}"
+
+  // number of entries
+  size_t size() const;
+};
+
+// range of successive blocks of rows of a dataset, see "File::iterate": the next block is read by
+// a background thread while the current block is processed, using two data buffers that are
+// allocated once (only a small task is queued per block), e.g.
+//
+//   for ( auto &block : file.iterate<double>("/u", 100) ) ...
+//
+// NB a block is valid until the iterator is incremented
+// NB while a block is read, the functions of the "File" wait for it to be read; other files (or
+//    the HDF5 library directly) may not be used while iterating, unless HDF5 is thread-safe
+// NB the range can be iterated once
+
+template<typename T>
+class Blocks
+{
+public:
+
+  class iterator
+  {
+  public:
+
+    iterator(Blocks *blocks, size_t index);
+
+    const Block<T>& operator*() const;
+    const Block<T>* operator->() const;
+
+    iterator& operator++();
+
+    bool operator==(const iterator &other) const;
+    bool operator!=(const iterator &other) const;
+
+  private:
+
+    Blocks* m_blocks;
+    size_t  m_index;
+  };
+
+  Blocks() = default;
+  Blocks(Blocks &&) = default;
+  Blocks& operator=(Blocks &&) = default;
+
+  // wait for the block that is being read
+  ~Blocks();
+
+  // iterate: the first block is read by "begin()" (if it was not already read)
+  iterator begin();
+  iterator end();
+
+  // number of blocks, number of rows per block
+  size_t size() const;
+  size_t block() const;
+
+private:
+
+  friend class File;
+
+  // (internal) read block "index" to buffer "index % 2", in the background
+  void prefetch(size_t index);
+
+  // (internal) wait for block "index" to be read, make it the current block
+  void fetch(size_t index);
+
+  std::shared_ptr<AsyncWriter> m_worker;     // background thread that reads
+  std::string                  m_path;
+  H5::DataSet                  m_dataset;
+  H5::DataType                 m_type;       // data-type of "T"
+  size_t                       m_rows=0;     // number of rows of the dataset
+  size_t                       m_block=0;    // number of rows per block
+  size_t                       m_nblocks=0;  // number of blocks
+  size_t                       m_frame=0;    // number of entries per row
+  std::vector<T>               m_buffer[2];
+  std::vector<hsize_t>         m_offset[2];  // hyperslab of the block in each buffer
+  std::vector<hsize_t>         m_count[2];
+  std::future<void>            m_pending;    // block that is being read
+  size_t                       m_next=0;     // index of the block that is being read
+  Block<T>                     m_current;
+};
+
+// ========================================= FILE OPTIONS ==========================================
+
+// options used when creating (or opening) a file, see "File(fname, mode, options)"
+// NB the default value (0, false, or negative) of each option is the default of the HDF5 library
+// NB "max_compact" and "min_dense" apply to all groups, "page_size" to newly created files, the
+//    other options to how the file is accessed
+// NB presets, to start from:
+//    - "manySmallDatasets" : compact object headers, large metadata blocks and cache
+//    - "fewHugeArrays"     : large chunk cache, datasets aligned to file-system blocks
+//    - "streamingAppend"   : chunk index for extendable datasets, written chunks are evicted first
+//    - "inMemory"          : the file is kept in memory, optionally written to disk on closing
+
+struct FileOptions
+{
+  // I/O driver: POSIX I/O (default), in memory ("core"), or bypassing the system cache ("direct")
+  enum Driver { Sec2, Core, Direct };
+
+  // creation: groups
+  unsigned max_compact=0;         // links stored in the header of a group, at most (default 8)
+  unsigned min_dense=0;           // links stored in an index of a group, at least (default 6)
+
+  // creation: paged allocation of file space (required for page buffering)
+  size_t   page_size=0;           // size of a page [bytes] (0: no paged allocation)
+
+  // access: format and allocation
+  bool     latest_format=false;   // latest file format (faster and more compact object headers,
+                                  // but the file can only be read by this version of HDF5 or newer)
+  size_t   meta_block_size=0;     // minimum size of blocks that are allocated for metadata [bytes]
+  size_t   alignment=0;           // align objects of at least "alignment_threshold" bytes [bytes]
+  size_t   alignment_threshold=0;
+
+  // access: caches
+  size_t   chunk_cache_bytes=0;   // size of the chunk cache of each dataset (default 1MB) [bytes]
+  size_t   chunk_cache_slots=0;   // number of chunk slots, preferably a prime (default 521)
+  double   chunk_cache_w0=-1.0;   // preference to evict fully read/written chunks [0..1] (0.75)
+  size_t   metadata_cache=0;      // initial size of the metadata cache [bytes] (default 2MB)
+  size_t   page_buffer_size=0;    // size of the page buffer [bytes] (requires "page_size")
+
+  // access: driver
+  Driver   driver=Sec2;
+  size_t   core_increment=0;      // "core": size by which memory grows (default 1MB) [bytes]
+  bool     core_write_back=true;  // "core": write the file to disk when it is closed
+
+  // presets
+  static FileOptions manySmallDatasets();
+  static FileOptions fewHugeArrays();
+  static FileOptions streamingAppend();
+  static FileOptions inMemory(bool write_back=false);
+
+  // (advanced) file creation and file access property lists
+  H5::FileCreatPropList createPlist() const;
+  H5::FileAccPropList accessPlist() const;
+};
 
 // ================================== CLASS DEFINTION (OVERVIEW) ===================================
 
+class Batch;
+
+// rank of a "Dataset" that is not fixed (at compile time)
+const size_t dynamic_rank = static_cast<size_t>(-1);
+
+template<typename T, size_t Rank=dynamic_rank> class Dataset;
+
+// timing of a batch of write operations, see "Batch::commit" [seconds]
+
+struct BatchStats
+{
+  size_t writes=0;   // number of write operations
+  size_t bytes=0;    // number of bytes written
+  double groups=0.0; // time spent creating groups
+  double write=0.0;  // time spent creating datasets and writing
+  double flush=0.0;  // time spent flushing
+  double total=0.0;  // total time
+};
+
 class File
 {
 private:
-  H5::H5File  m_file;
-  std::string m_fname;
-  bool        m_autoflush;
+
+  friend class Batch;
+
+  template<typename T, size_t Rank> friend class Dataset;
+
+  // (internal) pending entries "[start, start+n)" along the first axis of an extendable dataset
+  // NB each entry is a scalar (for a dataset of rank 1) or a frame of a fixed shape
+  struct AppendBuffer
+  {
+    H5::DataType         type;       // data-type of the entries
+    std::vector<size_t>  frame;      // shape of each entry (empty for scalars)
+    size_t               start;      // index of the first pending entry
+    size_t               n;          // number of pending entries
+    size_t               chunk_size; // number of entries per chunk (entries are written per chunk)
+    std::vector<hsize_t> chunk;      // chunk shape, used when the dataset is created
+    DataSetOptions       options;    // filters, used when the dataset is created
+    std::vector<char>    fill_val;   // fill value, used when the dataset is created (if not empty)
+    std::vector<char>    data;       // pending entries
+  };
+
+  // (internal) open dataset or group, and its position in the least-recently-used list
+  struct Handle
+  {
+    bool                             is_group;
+    H5::DataSet                      dataset;
+    H5::Group                        group;
+    std::list<std::string>::iterator lru;
+  };
+
+  H5::H5File                              m_file;
+  std::string                             m_fname;
+  FlushPolicy                             m_flush=FlushPolicy::always();
+  FlushStats                              m_flush_stats;
+  size_t                                  m_flush_writes=0;    // writes since last flush
+  size_t                                  m_flush_bytes=0;     // bytes written since last flush
+  DataSetOptions                          m_options;           // default storage of arrays
+  std::chrono::steady_clock::time_point   m_flush_last=std::chrono::steady_clock::now();
+  std::map<std::string, AppendBuffer>     m_append;
+  std::unordered_map<std::string, Handle> m_cache;
+  std::list<std::string>                  m_lru;               // most recently used first
+  size_t                                  m_cache_size=256;    // maximum number of open handles
+  size_t                                  m_cache_hits=0;
+  size_t                                  m_cache_misses=0;
+  mutable std::unordered_set<std::string> m_groups;            // groups known to exist
+  std::shared_ptr<AsyncWriter>            m_async;             // background writer (if enabled)
+  std::shared_ptr<AsyncWriter>            m_reader;            // background reader of "iterate"
+  bool                                    m_batch=false;       // committing a batch
+  H5::DSetMemXferPropList                 m_xfer;              // transfer of writes to slices
+  size_t                                  m_threads=1;         // threads to (de)compress chunks
+  #ifdef HDF5PP_MPI
+  bool                                    m_mpi=false;         // file opened by all of "m_comm"
+  MPI_Comm                                m_comm=MPI_COMM_NULL;
+  #endif
+
+  FileOptions                             m_file_options;      // options used to create groups
+
+  // (internal) open the file, using specific file-creation and file-access properties
+  void open(const std::string &mode, const H5::FileCreatPropList &create,
+    const H5::FileAccPropList &access);
+
+  // (internal) wait for asynchronous writes to finish, unless called from the background thread
+  // NB called by all functions that access the file, such that they see all submitted writes
+  void waitAsync() const;
+
+  // (internal) background thread that reads the blocks of "iterate": the background writer (if
+  // enabled, such that reads and writes are executed in order), or a dedicated thread
+  std::shared_ptr<AsyncWriter> reader();
+
+  // (internal) submit "fn(args...)" to the background writer (or execute it if there is none)
+  // NB the arguments are stored by value: containers are moved (if possible) or copied
+  template<class Fn, class... Args>
+  std::future<void> submit(Fn fn, Args&&... args);
+
+  // (internal) write the pending entries of an extendable dataset to the file
+  void writePending(const std::string &path);
+
+  // (internal) write the pending entries of all extendable datasets to the file
+  void writePending();
+
+  // (internal) register a write operation of "nbytes", flush the file if the policy requires it
+  // NB during "Batch::commit" the file is not flushed, "flushDue" is checked once afterwards
+  void autoflush(size_t nbytes);
+
+  // (internal) check if the flush policy requires a flush
+  bool flushDue() const;
+
+  // (internal) flush the file (without writing pending entries), update counters
+  void flushFile();
+
+  // (internal) open a dataset, after writing its pending entries (if any)
+  // NB the handle is cached, see "setCacheSize"
+  H5::DataSet openDataSet(const std::string &path);
+
+  // (internal) open a group
+  // NB the handle is cached, see "setCacheSize"
+  H5::Group openGroup(const std::string &path);
+
+  // (internal) create a dataset in its (existing) parent group, and cache its handle
+  H5::DataSet createDataSet(const std::string &path, const H5::DataType &datatype,
+    const H5::DataSpace &dataspace,
+    const H5::DSetCreatPropList &plist=H5::DSetCreatPropList::DEFAULT);
+
+  // (internal) create a dataset for an array of a specific shape and storage
+  H5::DataSet createArray(const std::string &path, const H5::DataType& HT,
+    const std::vector<size_t> &shape, const DataSetOptions &options, size_t itemsize);
+
+  // (internal) store a handle in the cache, close the least recently used handle if needed
+  void cache(const std::string &path, const Handle &handle);
+
+  // (internal) remove the handles of a path, and of all paths in it, from the cache
+  void uncache(const std::string &path);
+
+  // (internal) select the hyperslab "start[i] + j*stride[i]" for "j < count[i]" in the data-space
+  // of a dataset, check that it is within the shape of the dataset (empty "stride" == 1)
+  H5::DataSpace hyperslab(const H5::DataSet &dataset, const std::string &path,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride);
+
+  // (internal) read/write an entire dataset, from/to a buffer of data-type "HT"
+  // NB if enabled (see "setThreads"), chunks are (de)compressed by several threads
+  template<typename T>
+  void readData(H5::DataSet &dataset, const std::string &path, T *output, const H5::DataType& HT);
+
+  template<typename T>
+  void writeData(H5::DataSet &dataset, const std::string &path, const T *input,
+    const H5::DataType& HT);
+
+  #ifdef HDF5PP_ZLIB
+
+  // (internal) check if the chunks of a dataset can be (de)compressed by several threads
+  // (for reading: all chunks have to be allocated), collect its properties in "pipe"
+  bool chunkPipeline(H5::DataSet &dataset, const H5::DataType& HT, size_t itemsize, bool read,
+    ChunkPipeline &pipe);
+
+  // (internal) read/write all chunks raw, (de)compress them using "m_threads" threads
+  void readChunks(H5::DataSet &dataset, const std::string &path, char *output,
+    const ChunkPipeline &pipe);
+
+  void writeChunks(H5::DataSet &dataset, const std::string &path, const char *input,
+    const ChunkPipeline &pipe);
+
+  #endif
+
+  // (internal) memory-map the data of a contiguous dataset of "nbytes" (with items of data-type
+  // "HT" and alignment "align"), return a pointer to the data, or "nullptr" if it cannot be mapped
+  // NB "region" keeps the mapping alive
+  const void* mapDataSet(H5::DataSet &dataset, const H5::DataType& HT, size_t nbytes,
+    size_t align, std::shared_ptr<const void> &region);
+
+  // (internal) extend a dataset such that it contains the hyperslab "start[i] + j*stride[i]" for
+  // "j < count[i]", along the axes along which this is allowed by its maximum shape
+  void extendDataSet(H5::DataSet &dataset, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, const std::vector<size_t> &stride);
+
+  // (internal) "read<T>(path)": overloaded on the requested type
+  template<typename T> struct Tag {};
+
+  template<typename T> T read_impl(std::string path, Tag<T>);
+
+  template<typename T> std::vector<T> read_impl(std::string path, Tag<std::vector<T>>);
+
+  #ifdef HDF5PP_EIGEN
+
+  template<typename T> Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor>
+  read_impl(std::string path, Tag<Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor>>);
+
+  template<typename T> Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
+  read_impl(std::string path, Tag<Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>);
+
+  #endif
+
+  #ifdef HDF5PP_CPPMAT
+
+  template<typename T> cppmat::array<T> read_impl(std::string path, Tag<cppmat::array<T>>);
+
+  #endif
+
+  #ifdef HDF5PP_XTENSOR
+
+  // (internal) write an nd-array to the hyperslab "start[i] + j*stride[i]" of an opened dataset
+  // (empty "start" == the entire dataset), without evaluating it to a temporary:
+  // - contiguous row-major container: written directly from its buffer
+  // - other expressions (lazy expressions, strided views, ...): streamed per block of rows along
+  //   the first axis, through a staging buffer of about 1MB
+  template<class E> void xwrite_impl(H5::DataSet &dataset, const std::string &path,
+    const E &data, const std::vector<size_t> &start, const std::vector<size_t> &stride,
+    std::true_type);
+
+  template<class E> void xwrite_impl(H5::DataSet &dataset, const std::string &path,
+    const E &data, const std::vector<size_t> &start, const std::vector<size_t> &stride,
+    std::false_type);
+
+  #endif
 
 public:
 
@@ -93,27 +822,136 @@ public:
 
   File(const std::string &fname, const std::string &mode="w", bool autoflush=true);
 
+  File(const std::string &fname, const std::string &mode, const FlushPolicy &policy);
+
+  // open with specific file options, e.g. to tune files with many (small) datasets
+  File(const std::string &fname, const std::string &mode, const FileOptions &options,
+    const FlushPolicy &policy=FlushPolicy::always());
+
+  // open a file image (see "image()") in memory: "r" read-only, "a" or "r+" to modify the copy
+  File(const std::vector<char> &image, const std::string &mode="r",
+    const FlushPolicy &policy=FlushPolicy::always());
+
+  #ifdef HDF5PP_MPI
+
+  // open the file in parallel (MPI-IO): collectively by all processes in "comm"
+  // NB functions that create, extend, or unlink datasets and groups, and "flush", are collective:
+  //    all processes have to call them (with the same path, shape, ...)
+  // NB "write_slice" and "overwrite_slice" are collective writes: all processes call them, each
+  //    with its own hyperslab (possibly empty)
+  // NB the flush policies "bytes" and "interval" are not allowed: they differ between processes
+  File(const std::string &fname, const std::string &mode, MPI_Comm comm,
+    MPI_Info info=MPI_INFO_NULL, const FlushPolicy &policy=FlushPolicy::checkpoint());
+
+  #endif
+
+  // copying is not possible: both copies would write the pending entries, and the cached handles
+  // refer to the list of the original
+  File(const File &) = delete;
+  File(File &&) = default;
+  File& operator=(const File &) = delete;
+  File& operator=(File &&) = default;
+
+  // destructor: write the pending entries of extendable datasets
+  ~File();
+
   // support functions
   // -----------------
 
   // return the filename
   std::string fname() const;
 
+  // image of the file (e.g. of an in-memory file), after writing all pending entries
+  std::vector<char> image();
+
   // flush all buffers associated with a file to disk
   // NB if 'autoflush==true' you don't need to call this function, all 'write' functions call it
+  // NB the pending entries of extendable datasets are written to the file first
   void flush();
 
+  // flush the file at a consistent state, unless the flush policy is "never"
+  void checkpoint();
+
+  // set/get the policy that determines when write operations flush the file
+  void setFlushPolicy(const FlushPolicy &policy);
+  FlushPolicy flushPolicy() const;
+
+  // return counters of write and flush operations
+  FlushStats flushStats() const;
+
+  // set/get the default storage (chunking and compression) of arrays that are written
+  void setDataSetOptions(const DataSetOptions &options);
+  DataSetOptions dataSetOptions() const;
+
+  // set/get the number of threads that (de)compress chunks when reading or writing entire arrays
+  // NB only for arrays whose only filters are "deflate" and/or "shuffle", if zlib is included
+  //    (see "HDF5PP_ZLIB"); otherwise, or for "n <= 1", the HDF5 library applies the filters
+  void setThreads(size_t n);
+  size_t threads() const;
+
+  // start a batch of write operations, that are performed (with a single flush) on "commit()"
+  Batch batch();
+
+  // handle to an existing dataset of rank "Rank" (if fixed), that is validated once (existence,
+  // precision, and rank), such that repeated reads and writes are not checked, see "Dataset"
+  template<typename T, size_t Rank=dynamic_rank>
+  Dataset<T,Rank> dataset(const std::string &path);
+
+  // handle to a dataset, that is created with shape "shape" (and the default or specific storage)
+  // if needed; an existing dataset should have shape "shape" (except along extendable axes)
+  template<typename T, size_t Rank=dynamic_rank>
+  Dataset<T,Rank> dataset(const std::string &path, const std::vector<size_t> &shape);
+
+  template<typename T, size_t Rank=dynamic_rank>
+  Dataset<T,Rank> dataset(const std::string &path, const std::vector<size_t> &shape,
+    const DataSetOptions &options);
+
+  // asynchronous writes
+  // -------------------
+
+  // enable/disable a background thread that performs the "*_async" writes, in order
+  // NB at most "max_pending" writes are queued, submitting more blocks until there is space
+  // NB other functions first wait for the pending writes, the "File" may not be moved or copied
+  //    while writes are pending
+  void setAsync(bool async, size_t max_pending=64);
+  bool async() const;
+
+  // submit "write(path, args...)", "overwrite(path, args...)", or "append(path, args...)", e.g.
+  // "file.write_async("/data", std::move(data), shape)" (no copy) or
+  // "file.write_async("/data", data, shape)" (copy of "data"), returns a future that holds any
+  // exception; without background thread the write is executed immediately
+  // NB the arguments are stored by value, lazy (e.g. xtensor) expressions must be evaluated first
+  template<class... Args> std::future<void> write_async(std::string path, Args&&... args);
+  template<class... Args> std::future<void> overwrite_async(std::string path, Args&&... args);
+  template<class... Args> std::future<void> append_async(std::string path, Args&&... args);
+
+  // wait for all asynchronous writes to finish
+  // NB rethrows the exception of the first write that failed since the last call (if any)
+  void drain();
+
   // check if a path exists (is a group or a dataset)
+  // NB groups that are found are remembered, such that checking their content is a single lookup
   bool exists(const std::string &path) const;
 
   // create a group
   // NB there is usually no need to call this function, all 'write' functions call it
+  // NB the groups are remembered, such that they are only checked and created once
   void createGroup(std::string path);
 
   // unlink a path
   // WARNING the space in the file may not be freed, use: $ h5repack file1 file2
   void unlink(std::string path);
 
+  // set the maximum number of cached open datasets and groups (0 disables the cache)
+  void setCacheSize(size_t n);
+
+  // close all cached datasets and groups
+  void clearCache();
+
+  // number of lookups of datasets and groups that were served from the cache, or not
+  size_t cacheHits() const;
+  size_t cacheMisses() const;
+
   // read the shape of the data
   std::vector<size_t> shape(std::string path);
 
@@ -131,14 +969,16 @@ public:
   std::vector<size_t> shape(const H5::DataSet   &dataset  );
   std::vector<size_t> shape(const H5::DataSpace &dataspace);
 
-  // (advanced) check if an opened dataset has the exact precision of the template type
+  // (advanced) check if an opened dataset can be read as the template type without loss of
+  // precision: the same class of data-type (integer, floating-point, ...), of at most as many bytes
   template<typename T>
   bool correct_presision(const H5::DataSet &dataset);
 
   // read from file
   // --------------
 
-  // read as specific data-type, e.g. double, Eigen<double,...>, cppmat::array<double>, ...
+  // read as specific data-type, e.g. double, std::vector<double>, Eigen<double,...>,
+  // cppmat::array<double>, ..., of any type that is registered in "TypeTraits"
   // NB double, int, etc. -> data can contain only exactly one entry
   //    std::string       -> data can contain only a string
   template<typename T>
@@ -150,15 +990,54 @@ public:
 
   // (advanced) read scalar of arbitrary type from a dataset containing exactly one entry
   template<typename T>
-  T read_scalar(std::string path, const H5::PredType& HT);
+  T read_scalar(std::string path, const H5::DataType& HT);
 
   // (advanced) read scalar of arbitrary type from a dataset (scalar, or of rank 1)
   template<typename T>
-  T read(std::string path, const H5::PredType& HT, size_t index);
+  T read(std::string path, const H5::DataType& HT, size_t index);
 
   // (advanced) read "std::vector" of arbitrary type from a dataset of arbitrary rank
   template<typename T>
-  std::vector<T> read_vector(std::string path, const H5::PredType& HT);
+  std::vector<T> read_vector(std::string path, const H5::DataType& HT);
+
+  // read a hyperslab of a dataset of arbitrary rank: "start[i] + j*stride[i]" for "j < count[i]"
+  // along each dimension "i", as "std::vector" of size "prod(count)" (row-major)
+  template<typename T>
+  std::vector<T> read_slice(std::string path, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, const std::vector<size_t> &stride={});
+
+  // (advanced) read a hyperslab of arbitrary type to a preallocated buffer of "prod(count)" entries
+  template<typename T>
+  void read_slice(std::string path, T *output, const H5::DataType& HT,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride={});
+
+  // read-only view of a dataset of arbitrary rank, without reading it: for a contiguous dataset
+  // (uncompressed, the default) that is stored as in memory, the file is memory-mapped, otherwise
+  // the dataset is read, see "Mapped"
+  template<typename T>
+  Mapped<T> map(std::string path);
+
+  // iterate over blocks of "block" rows (along the first axis) of a dataset of arbitrary rank,
+  // the next block is read in the background, see "Blocks", e.g.
+  // "for ( auto &b : file.iterate<double>("/u", 100) ) process(b.data, b.shape);"
+  // NB the number of rows is that when the range is created
+  template<typename T>
+  Blocks<T> iterate(std::string path, size_t block);
+
+  // read a dataset of arbitrary rank to a preallocated buffer of "size" entries (row-major)
+  // NB "size" must be equal to the size of the dataset, nothing is allocated
+  template<typename T>
+  void read_into(std::string path, T *output, size_t size);
+
+  // (advanced) read a dataset of arbitrary type to a preallocated buffer of "size" entries
+  template<typename T>
+  void read_into(std::string path, T *output, const H5::DataType& HT, size_t size);
+
+  // read a dataset of arbitrary rank to an existing "std::vector" (row-major)
+  // NB the vector is only resized if its size differs from that of the dataset
+  template<typename T>
+  void read_into(std::string path, std::vector<T> &output);
 
   // write to file
   // -------------
@@ -166,148 +1045,205 @@ public:
   // write "std::string" to string dataset
   void write(std::string path, std::string data);
 
-  // write scalar to scalar dataset (non-extendable)
-  void write(std::string path, int    data);
-  void write(std::string path, size_t data);
-  void write(std::string path, float  data);
-  void write(std::string path, double data);
+  // write scalar (of a type registered in "TypeTraits") to scalar dataset (non-extendable)
+  template<typename T, typename = typename std::enable_if<TypeTraits<T>::value>::type>
+  void write(std::string path, T data);
 
   // write scalar as (part of) an extendable dataset of rank 1
-  void write(std::string path, int    data, size_t index, int    fillval=0  , size_t chunk_size=64000);
-  void write(std::string path, size_t data, size_t index, size_t fillval=0  , size_t chunk_size=64000);
-  void write(std::string path, float  data, size_t index, float  fillval=0.0, size_t chunk_size=64000);
-  void write(std::string path, double data, size_t index, double fillval=0.0, size_t chunk_size=64000);
+  template<typename T, typename = typename std::enable_if<TypeTraits<T>::value>::type>
+  void write(std::string path, T data, size_t index, T fillval=T(), size_t chunk_size=64000);
+
+  // append a frame (an array of a fixed shape) along the first axis of an extendable dataset of
+  // shape "(n, frame...)", that is created if needed (with "frame" default to "{data.size()}")
+  // NB frames are buffered, and written per chunk (or on "flush()")
+  template<typename T>
+  void append(std::string path, const std::vector<T> &data, const std::vector<size_t> &frame={});
+
+  // (advanced) append a frame of arbitrary type, stored in a buffer of "prod(frame)" entries
+  template<typename T>
+  void append(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &frame);
+
+  // (advanced) append a frame of arbitrary type, with specific storage that is used if the dataset
+  // is created (the chunk shape, if specified, includes the first axis)
+  template<typename T>
+  void append(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &frame, const DataSetOptions &options);
 
   // write "std::vector" to a dataset of arbitrary shape
-  void write(std::string path, const std::vector<int>    &data,const std::vector<size_t> &shape={});
-  void write(std::string path, const std::vector<size_t> &data,const std::vector<size_t> &shape={});
-  void write(std::string path, const std::vector<float>  &data,const std::vector<size_t> &shape={});
-  void write(std::string path, const std::vector<double> &data,const std::vector<size_t> &shape={});
+  template<typename T>
+  void write(std::string path, const std::vector<T> &data, const std::vector<size_t> &shape={});
 
   // (advanced) write scalar of arbitrary type to a dataset containing exactly one entry
-  template<typename T>
-  void write(std::string path, T data, const H5::PredType& HT);
+  template<typename T, typename = typename std::enable_if<!IsVector<T>::value>::type>
+  void write(std::string path, T data, const H5::DataType& HT);
 
   // (advanced) write scalar of arbitrary type as (part of) an extendable dataset of rank 1
+  // NB consecutive entries are buffered, and written per "chunk_size" entries (or on "flush()")
   template<typename T>
-  void write(std::string path, T data, const H5::PredType& HT, size_t index, T fill_val,
+  void write(std::string path, T data, const H5::DataType& HT, size_t index, T fill_val,
     size_t chunk_size);
 
   // (advanced) write array or any type and of arbitrary shape or rank
   template<typename T>
-  void write(std::string path, const T *input, const H5::PredType& HT,
+  void write(std::string path, const T *input, const H5::DataType& HT,
     const std::vector<size_t> &shape);
 
+  // (advanced) write array or any type and of arbitrary shape or rank, with specific storage
+  template<typename T>
+  void write(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &shape, const DataSetOptions &options);
+
   // (advanced) write std::vector of arbitrary type to a dataset of arbitrary rank
   template<typename T>
-  void write(std::string path, const std::vector<T> &data, const H5::PredType& HT,
+  void write(std::string path, const std::vector<T> &data, const H5::DataType& HT,
     const std::vector<size_t> &shape);
 
+  // (advanced) write std::vector of arbitrary type to a dataset of arbitrary rank, with
+  // specific storage
+  template<typename T>
+  void write(std::string path, const std::vector<T> &data, const H5::DataType& HT,
+    const std::vector<size_t> &shape, const DataSetOptions &options);
+
   // overwrite to file
   // -----------------
 
   // overwrite scalar to scalar dataset (non-extendable)
-  void overwrite(std::string path, int    data);
-  void overwrite(std::string path, size_t data);
-  void overwrite(std::string path, float  data);
-  void overwrite(std::string path, double data);
+  template<typename T, typename = typename std::enable_if<TypeTraits<T>::value>::type>
+  void overwrite(std::string path, T data);
 
   // overwrite "std::vector" to a dataset of arbitrary shape
-  void overwrite(std::string path, const std::vector<int>    &data,const std::vector<size_t> &shape={});
-  void overwrite(std::string path, const std::vector<size_t> &data,const std::vector<size_t> &shape={});
-  void overwrite(std::string path, const std::vector<float>  &data,const std::vector<size_t> &shape={});
-  void overwrite(std::string path, const std::vector<double> &data,const std::vector<size_t> &shape={});
+  template<typename T>
+  void overwrite(std::string path, const std::vector<T> &data, const std::vector<size_t> &shape={});
 
   // (advanced) overwrite scalar of arbitrary type to a dataset containing exactly one entry
-  template<typename T>
-  void overwrite(std::string path, T data, const H5::PredType& HT);
+  template<typename T, typename = typename std::enable_if<!IsVector<T>::value>::type>
+  void overwrite(std::string path, T data, const H5::DataType& HT);
 
   // (advanced) overwrite array or any type and of arbitrary shape or rank
   template<typename T>
-  void overwrite(std::string path, const T *input, const H5::PredType& HT,
+  void overwrite(std::string path, const T *input, const H5::DataType& HT,
     const std::vector<size_t> &shape);
 
   // (advanced) overwrite std::vector of arbitrary type to a dataset of arbitrary rank
   template<typename T>
-  void overwrite(std::string path, const std::vector<T> &data, const H5::PredType& HT,
+  void overwrite(std::string path, const std::vector<T> &data, const H5::DataType& HT,
     const std::vector<size_t> &shape);
 
+  // overwrite a hyperslab of an existing dataset of arbitrary rank (see "read_slice"), the dataset
+  // is extended if the hyperslab exceeds its shape along axes that are extendable
+  template<typename T>
+  void overwrite_slice(std::string path, const std::vector<T> &data,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride={});
+
+  // (advanced) overwrite a hyperslab from a buffer of arbitrary type of "prod(count)" entries
+  template<typename T>
+  void overwrite_slice(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride={});
+
+  // (advanced) write a hyperslab, the dataset is first created with shape "shape" if needed
+  // (the entries that are not written are zero)
+  template<typename T>
+  void write_slice(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &shape, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, const std::vector<size_t> &stride={});
+
+  // (advanced) write a hyperslab, the dataset is first created with shape "shape" and specific
+  // storage if needed (e.g. with a maximum shape to allow extension)
+  template<typename T>
+  void write_slice(std::string path, const T *input, const H5::DataType& HT,
+    const std::vector<size_t> &shape, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, const std::vector<size_t> &stride,
+    const DataSetOptions &options);
+
   // plugin: Eigen
   // -------------
 
   #ifdef HDF5PP_EIGEN
 
   // write column to dataset of rank 1
-  void write(std::string path, const Eigen::Matrix<int   ,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void write(std::string path, const Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void write(std::string path, const Eigen::Matrix<float ,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void write(std::string path, const Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor> &data);
+  template<typename T>
+  void write(std::string path, const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data);
 
   // write matrix to dataset of rank 2
+  template<typename T>
   void write(std::string path,
-    const Eigen::Matrix<int  ,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+    const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
 
+  // (advanced) write column of arbitrary type to dataset of rank 1
+  template<typename T>
   void write(std::string path,
-    const Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+    const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data,
+    const H5::DataType& HT);
 
+  // (advanced) write matrix of arbitrary type to dataset of rank 2
+  template<typename T>
   void write(std::string path,
-    const Eigen::Matrix<float ,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+    const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data,
+    const H5::DataType& HT);
 
-  void write(std::string path,
-    const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+  // append column as frame of an extendable dataset of rank 2 (see "append")
+  template<typename T>
+  void append(std::string path, const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data);
 
-  // (advanced) write column of arbitrary type to dataset of rank 1
+  // append matrix as frame of an extendable dataset of rank 3 (see "append")
+  template<typename T>
+  void append(std::string path,
+    const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+
+  // (advanced) write column of arbitrary type to dataset of rank 1, with specific storage
   template<typename T>
   void write(std::string path,
     const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data,
-    const H5::PredType& HT);
+    const H5::DataType& HT, const DataSetOptions &options);
 
-  // (advanced) write matrix of arbitrary type to dataset of rank 2
+  // (advanced) write matrix of arbitrary type to dataset of rank 2, with specific storage
   template<typename T>
   void write(std::string path,
     const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data,
-    const H5::PredType& HT);
+    const H5::DataType& HT, const DataSetOptions &options);
 
   // overwrite column to dataset of rank 1
-  void overwrite(std::string path, const Eigen::Matrix<int   ,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void overwrite(std::string path, const Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void overwrite(std::string path, const Eigen::Matrix<float ,Eigen::Dynamic,1,Eigen::ColMajor> &data);
-  void overwrite(std::string path, const Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor> &data);
+  template<typename T>
+  void overwrite(std::string path, const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data);
 
   // overwrite matrix to dataset of rank 2
+  template<typename T>
   void overwrite(std::string path,
-    const Eigen::Matrix<int  ,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
-
-  void overwrite(std::string path,
-    const Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
-
-  void overwrite(std::string path,
-    const Eigen::Matrix<float ,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
-
-  void overwrite(std::string path,
-    const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+    const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
 
   // (advanced) overwrite column of arbitrary type to dataset of rank 1
   template<typename T>
   void overwrite(std::string path,
     const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &data,
-    const H5::PredType& HT);
+    const H5::DataType& HT);
 
   // (advanced) overwrite matrix of arbitrary type to dataset of rank 2
   template<typename T>
   void overwrite(std::string path,
     const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data,
-    const H5::PredType& HT);
+    const H5::DataType& HT);
 
   // (advanced) read data of arbitrary type to Eigen column
   template<typename T>
   Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> read_eigen_column(std::string path,
-    const H5::PredType& HT);
+    const H5::DataType& HT);
 
   // (advanced) read data of arbitrary type to Eigen matrix
   template<typename T>
   Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> read_eigen_matrix(std::string path,
-    const H5::PredType& HT);
+    const H5::DataType& HT);
+
+  // read data to an existing Eigen column, only resized if its size differs from the dataset
+  template<typename T>
+  void read_into(std::string path, Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &output);
+
+  // read dataset of rank 2 to an existing Eigen matrix, only resized if its shape differs
+  template<typename T>
+  void read_into(std::string path,
+    Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &output);
 
   #endif
 
@@ -317,28 +1253,33 @@ public:
   #ifdef HDF5PP_CPPMAT
 
   // write nd-array to dataset of matching rank
-  void write(std::string path, const cppmat::array<int   > &data);
-  void write(std::string path, const cppmat::array<size_t> &data);
-  void write(std::string path, const cppmat::array<float > &data);
-  void write(std::string path, const cppmat::array<double> &data);
+  template<typename T>
+  void write(std::string path, const cppmat::array<T> &data);
 
   // (advanced) write nd-array of arbitrary type to dataset of matching rank
   template<typename T>
-  void write(std::string path, const cppmat::array<T> &data, const H5::PredType& HT);
+  void write(std::string path, const cppmat::array<T> &data, const H5::DataType& HT);
+
+  // (advanced) write nd-array of arbitrary type to dataset of matching rank, with specific storage
+  template<typename T>
+  void write(std::string path, const cppmat::array<T> &data, const H5::DataType& HT,
+    const DataSetOptions &options);
 
   // overwrite nd-array to dataset of matching rank
-  void overwrite(std::string path, const cppmat::array<int   > &data);
-  void overwrite(std::string path, const cppmat::array<size_t> &data);
-  void overwrite(std::string path, const cppmat::array<float > &data);
-  void overwrite(std::string path, const cppmat::array<double> &data);
+  template<typename T>
+  void overwrite(std::string path, const cppmat::array<T> &data);
 
   // (advanced) overwrite nd-array of arbitrary type to dataset of matching rank
   template<typename T>
-  void overwrite(std::string path, const cppmat::array<T> &data, const H5::PredType& HT);
+  void overwrite(std::string path, const cppmat::array<T> &data, const H5::DataType& HT);
 
   // (advanced) read data of arbitrary type to cppmat::array
   template<typename T>
-  cppmat::array<T> read_cppmat_array(std::string path, const H5::PredType& HT);
+  cppmat::array<T> read_cppmat_array(std::string path, const H5::DataType& HT);
+
+  // read data to an existing cppmat::array, only resized if its shape differs from the dataset
+  template<typename T>
+  void read_into(std::string path, cppmat::array<T> &output);
 
   #endif
 
@@ -352,9 +1293,26 @@ public:
   // write nd-array to dataset of matching rank
   template<class E> void write(std::string path, const xt::xexpression<E> &data);
 
+  // write nd-array to dataset of matching rank, with specific storage (chunking, compression)
+  template<class E> void write(std::string path, const xt::xexpression<E> &data,
+    const DataSetOptions &options);
+
   // overwrite nd-array to dataset of matching rank
   template<class E> void overwrite(std::string path, const xt::xexpression<E> &data);
 
+  // append nd-array as frame of an extendable dataset of rank "data.dimension()+1" (see "append")
+  template<class E> void append(std::string path, const xt::xexpression<E> &data);
+
+  // overwrite nd-array to a hyperslab of an existing dataset of matching rank, with
+  // "count == data.shape()" (see "overwrite_slice")
+  template<class E> void overwrite_slice(std::string path, const xt::xexpression<E> &data,
+    const std::vector<size_t> &start, const std::vector<size_t> &stride={});
+
+  // write nd-array to a hyperslab, the dataset is first created with shape "shape" if needed
+  template<class E> void write_slice(std::string path, const xt::xexpression<E> &data,
+    const std::vector<size_t> &shape, const std::vector<size_t> &start,
+    const std::vector<size_t> &stride={});
+
   // read "xarray" of arbitrary type
   template<class T> auto xread(const std::string& path);
 
@@ -362,785 +1320,1168 @@ public:
   template<class T, size_t N> auto xread(const std::string& path);
 
   // (advanced) generic read
-  template<class T> T xread_impl(const std::string& path, const H5::PredType& HT);
+  template<class T> T xread_impl(const std::string& path, const H5::DataType& HT);
+
+  // read a hyperslab as "xarray" of shape "count", see "read_slice"
+  template<class T> auto xread_slice(const std::string& path, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, const std::vector<size_t> &stride={});
+
+  // read a hyperslab as "xtensor" of shape "count", see "read_slice"
+  template<class T, size_t N> auto xread_slice(const std::string& path,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride={});
+
+  // read a hyperslab to an existing (row-major) "xarray" or "xtensor", resized only if its shape
+  // differs from "count", see "read_slice"
+  template<class T> void xread_slice(const std::string& path, T &output,
+    const std::vector<size_t> &start, const std::vector<size_t> &count,
+    const std::vector<size_t> &stride={});
+
+  // read to an existing "xarray", only resized if its shape differs from the dataset
+  template<class T> void read_into(std::string path, xt::xarray<T> &output);
+
+  // read to an existing "xtensor" of matching rank, only resized if its shape differs
+  template<class T, size_t N> void read_into(std::string path, xt::xtensor<T,N> &output);
 
   #endif
 };
 
-// ======================================= SUPPPORT FUNCTION =======================================
-
-template<> inline H5::PredType getType<int   >() { return H5::PredType::NATIVE_INT;    }
-template<> inline H5::PredType getType<size_t>() { return H5::PredType::NATIVE_HSIZE;  }
-template<> inline H5::PredType getType<float >() { return H5::PredType::NATIVE_FLOAT;  }
-template<> inline H5::PredType getType<double>() { return H5::PredType::NATIVE_DOUBLE; }
+// =================================== BATCH OF WRITE OPERATIONS ===================================
 
-// ========================================= CONSTRUCTORS ==========================================
+// write operations that are recorded, and performed at once on "commit()": the groups of all paths
+// are created first, then all datasets are written, and the file is flushed (at most) once
+// (if the flush policy requires it), e.g.
+//
+//   file.batch().write("/inc/17/u", u).write("/inc/17/t", t).commit();
+//
+// NB the arguments are stored by value: containers are moved (if possible) or copied
+// NB the "File" has to exist until "commit()"
 
-inline File::File(const std::string &name, const std::string &mode_, bool autoflush)
+class Batch
 {
-  // copy mode
-  std::string mode = mode_;
+public:
 
-  // copy filename
-  m_fname = name;
+  Batch(File &file);
 
-  // check if the file exists
-  if ( mode == "r" )
-  {
-     // - find file
-    std::ifstream infile(m_fname);
-    // - throw error if file does not exist
-    if ( ! infile.good() ) std::runtime_error("HDF5pp: file does not exist ('"+name+"')");
-  }
+  // record "write(path, args...)", "overwrite(path, args...)", or "append(path, args...)"
+  template<class... Args> Batch& write(std::string path, Args&&... args);
+  template<class... Args> Batch& overwrite(std::string path, Args&&... args);
+  template<class... Args> Batch& append(std::string path, Args&&... args);
 
-  // check if file exists, otherwise set write mode to "w"
-  if ( mode == "a" or mode == "r+" )
-  {
-    // - find file
-    std::ifstream infile(m_fname);
-    // - change write mode if file does not exist
-    if ( ! infile.good() ) mode = "w";
-  }
+  // number of recorded operations
+  size_t size() const;
 
-  // open file
-  if      ( mode == "r"         ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_RDONLY);
-  else if ( mode == "w"         ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_TRUNC );
-  else if ( mode == "a" or "r+" ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_RDWR  );
-  else throw std::runtime_error("HDF5pp: unknown mode '"+mode+"'");
+  // discard the recorded operations
+  void clear();
 
-  // store flush settings
-  m_autoflush = autoflush;
-}
+  // perform the recorded operations (the batch is empty afterwards), return the timing
+  BatchStats commit();
 
-// ======================================= SUPPORT FUNCTIONS =======================================
+private:
 
-// ---------------------------------------- return filename ----------------------------------------
+  File*                              m_file;
+  std::vector<std::string>           m_paths;
+  std::vector<std::function<void()>> m_ops;
+};
 
-inline std::string File::fname() const
+// ======================================== DATASET HANDLE =========================================
+
+// handle to a dataset, see "File::dataset<T,Rank>(path)": the open dataset, its data-space, and
+// its shape are kept, and its existence, precision, and rank are checked once (when the handle is
+// created), such that its functions only do the HDF5 read or write (and a flush, following the
+// flush policy of the "File"), without looking up the path, e.g.
+//
+//   H5p::Dataset<double,2> u = file.dataset<double,2>("/u", {n, 3});
+//
+//   for ( ... ) u.write(data);
+//
+// NB "Rank" is the rank of the dataset, or "dynamic_rank" if it is not fixed; the shape (and the
+//    hyperslabs) are "std::array<size_t,Rank>", or "std::vector<size_t>"
+// NB the sizes of the input and output are only checked by "assert" (not if "NDEBUG" is defined),
+//    the bounds of hyperslabs are not checked
+// NB the handle is cheap to copy or move; the "File" has to exist (and may not be moved) while the
+//    handle is used, and the dataset may not be unlinked or extended by other means
+
+template<typename T, size_t Rank>
+class Dataset
 {
-  return m_fname;
-}
+public:
 
-// ------------------------------------------ flush file -------------------------------------------
+  // shape, and start, count, and stride of a hyperslab
+  using shape_type = typename std::conditional<Rank == dynamic_rank,
+    std::vector<size_t>, std::array<size_t,Rank>>::type;
 
-inline void File::flush()
-{
-  m_file.flush(H5F_SCOPE_GLOBAL);
-}
+  Dataset() = default;
 
-// -------------------------- check if path exists (is group or dataset) --------------------------
+  // path, rank, shape, and number of entries
+  std::string path() const;
+  size_t rank() const;
+  shape_type shape() const;
+  size_t shape(size_t i) const;
+  size_t size() const;
 
-inline bool File::exists(const std::string &path) const
+  // write the entire dataset, from "size()" entries (row-major)
+  void write(const T *input);
+  void write(const std::vector<T> &input);
+
+  // read the entire dataset, to "size()" preallocated entries (row-major)
+  void read(T *output);
+  std::vector<T> read();
+
+  // append a frame of "size()/shape(0)" entries along the first axis, that has to be extendable
+  // (e.g. "DataSetOptions::max_shape = {H5p::unlimited, ...}")
+  // NB the dataset is extended, and the frame written, immediately
+  void append(const T *input);
+  void append(const std::vector<T> &input);
+
+  // read a hyperslab "start[i] + j*stride[i]" for "j < count[i]" along each dimension "i", to
+  // "prod(count)" preallocated entries (row-major), see "File::read_slice"
+  // NB an empty stride (the default), or a stride of zero, is one
+  void read_slice(T *output, const shape_type &start, const shape_type &count,
+    const shape_type &stride={});
+
+  std::vector<T> read_slice(const shape_type &start, const shape_type &count,
+    const shape_type &stride={});
+
+  // write a hyperslab (see "read_slice"), from "prod(count)" entries (row-major)
+  void write_slice(const T *input, const shape_type &start, const shape_type &count,
+    const shape_type &stride={});
+
+  void write_slice(const std::vector<T> &input, const shape_type &start, const shape_type &count,
+    const shape_type &stride={});
+
+private:
+
+  friend class File;
+
+  // (internal) select a hyperslab in "m_space", return the number of selected entries
+  hsize_t select(const shape_type &start, const shape_type &count, const shape_type &stride);
+
+  // (internal) set the shape from that of the data-space "m_space"
+  void setShape();
+
+  // (internal) resize the shape, if its rank is not fixed
+  static void resize(std::vector<size_t> &shape, size_t rank) { shape.resize(rank); }
+  static void resize(std::array<size_t,Rank> &, size_t) {}
+
+  File*         m_file=nullptr;
+  std::string   m_path;
+  H5::DataSet   m_dataset;
+  H5::DataSpace m_space;   // data-space of the entire dataset
+  H5::DataType  m_type;    // data-type of "T"
+  shape_type    m_shape;
+  size_t        m_size=0;
+};
+
+// ======================================= ENSEMBLE OF FILES =======================================
+
+// read the same dataset(s) from many files (e.g. the outputs of a parameter sweep) in parallel; the
+// files are divided over a pool of "workers" (see "Ensemble::Pool"), the datasets are stacked: the
+// dataset of file "i" is entry "i" along the first axis (the stacked shape is "(nfile, ...)"), e.g.
+//
+//   H5p::Ensemble ensemble(files, 0, H5p::Ensemble::Processes);
+//   std::vector<double> u = ensemble.read<double>("/u");
+//
+// NB all files have to store the dataset with the same shape
+// NB the files are opened read-only, this process may not have them open for writing
+// NB "Processes" forks the calling process: only use it if no other thread uses HDF5 while reading
+//    (e.g. the background writer or reader of a "File", see "File::setAsync" and "File::iterate",
+//    have to be idle), and not in an MPI program (forking an MPI process is not supported)
+
+class Ensemble
 {
-  // find first "/"
-  size_t idx = path.find("/");
+public:
 
-  // loop over all groups
-  while ( true )
-  {
-    // - terminate if all "/" have been found
-    if ( std::string::npos == idx ) break;
-    // - create group if needed
-    if ( idx > 0 )
-    {
-      // -- get group name
-      std::string name(path.substr(0,idx));
-      // -- create if needed
-      if ( !m_file.exists(name.c_str()) ) return false;
-    }
-    // - proceed to next "/"
-    idx = path.find("/",idx+1);
-  }
+  // how the files are read:
+  // - Serial    : one after the other
+  // - Threads   : by a pool of threads (requires the thread-safe build of HDF5, whose global lock
+  //               covers each entire call, including the read from disk: essentially no speedup,
+  //               use "Processes" to scale)
+  // - Processes : by a pool of (forked) processes that write to shared memory (POSIX, see above)
+  enum Pool {Serial, Threads, Processes};
+
+  // constructor: list of files, number of workers (by default the number of cores; "Serial" uses
+  // one), pool (by default "Serial": a parallel pool has to be chosen explicitly)
+  Ensemble() = default;
+  Ensemble(const std::vector<std::string> &files, size_t workers=0, Pool pool=Serial);
+
+  // list of files, number of files, number of workers, pool
+  const std::vector<std::string>& files() const;
+  size_t size() const;
+  size_t workers() const;
+  Pool pool() const;
+
+  // stacked shape "(nfile, ...)" of a dataset (the shape is read from the first file)
+  std::vector<size_t> shape(const std::string &path) const;
+
+  // read a dataset from all files: the stacked data (row-major) of shape "shape(path)"
+  template<typename T>
+  std::vector<T> read(const std::string &path) const;
 
-  return m_file.exists(path.c_str());
-}
+  // (advanced) read several datasets from all files (opening each file once) into preallocated
+  // buffers, "outputs[j]" has "prod(shape(paths[j]))" entries
+  template<typename T>
+  void read(const std::vector<std::string> &paths, const std::vector<T*> &outputs) const;
 
-// ---------------------------------------- create a group -----------------------------------------
+  #ifdef HDF5PP_XTENSOR
+  // read a dataset from all files: the stacked data of shape "(nfile, ...)"
+  template<class T> xt::xarray<T> xread(const std::string &path) const;
 
-inline void File::createGroup(std::string path)
+  // read to an existing "xarray", only resized if its shape differs from "(nfile, ...)"
+  template<class T> void read_into(const std::string &path, xt::xarray<T> &output) const;
+
+  // read several datasets (opening each file once) to existing "xarray"s (resized if needed)
+  template<class T> void read_into(const std::vector<std::string> &paths,
+    const std::vector<xt::xarray<T>*> &outputs) const;
+  #endif
+
+private:
+
+  // (internal) read the datasets of file "i" to "outputs[j] + i * prod(shapes[j])"
+  template<typename T>
+  void readFile(size_t i, const std::vector<std::string> &paths,
+    const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const;
+
+  // (internal) read all files using a pool of threads or processes
+  template<typename T>
+  void readThreads(const std::vector<std::string> &paths,
+    const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const;
+
+  template<typename T>
+  void readProcesses(const std::vector<std::string> &paths,
+    const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const;
+
+  std::vector<std::string> m_files;
+  size_t                   m_workers=1;
+  Pool                     m_pool=Serial;
+};
+
+// ======================================= SUPPPORT FUNCTION =======================================
+
+// ------------------------------------- automatic chunk shape -------------------------------------
+
+inline std::vector<hsize_t> autoChunk(const std::vector<size_t> &shape, size_t itemsize)
 {
-  // find first "/"
-  size_t idx = path.find("/");
+  // bounds of the chunk size, in bytes
+  const double base = 16.*1024.;
+  const double min  = 8.*1024.;
+  const double max  = 1024.*1024.;
 
-  // loop over all groups
-  while ( true )
+  // start from the full shape (zero-sized dimensions get chunks of one item)
+  size_t rank = shape.size();
+
+  std::vector<hsize_t> chunk(rank);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+    chunk[i] = std::max(static_cast<hsize_t>(shape[i]), static_cast<hsize_t>(1));
+
+  if ( rank == 0 ) return chunk;
+
+  // total size of the dataset, and the target size of a chunk (that grows with the dataset size)
+  double size = static_cast<double>(itemsize);
+
+  for ( auto &i : chunk ) size *= static_cast<double>(i);
+
+  double target = std::min(std::max(base * std::pow(2., std::log10(size/max)), min), max);
+
+  // halve the chunk along each dimension in turn, until it is close to the target size
+  for ( size_t idx = 0 ; ; ++idx )
   {
-    // - terminate if all "/" have been found
-    if ( std::string::npos == idx ) return;
-    // - create group if needed
-    if ( idx > 0 )
-    {
-      // -- get group name
-      std::string name(path.substr(0,idx));
-      // -- create if needed
-      if ( !m_file.exists(name.c_str()) )
-        H5::Group group = m_file.createGroup(name.c_str());
-    }
-    // - proceed to next "/"
-    idx = path.find("/",idx+1);
+    double bytes = static_cast<double>(itemsize);
+
+    for ( auto &i : chunk ) bytes *= static_cast<double>(i);
+
+    if ( ( bytes < target || std::abs(bytes-target)/target < 0.5 ) && bytes < max ) break;
+
+    if ( bytes == static_cast<double>(itemsize) ) break;
+
+    hsize_t &dim = chunk[idx%rank];
+
+    dim = (dim+1)/2;
   }
+
+  return chunk;
 }
 
-// ----------------------------------------- unlink a path -----------------------------------------
+// =================================== DATASET CREATION OPTIONS ====================================
 
-inline void File::unlink(std::string path)
+// ------------------------------------- chunking is required --------------------------------------
+
+inline bool DataSetOptions::chunked() const
 {
-  m_file.unlink(path.c_str());
+  return max_shape.size() > 0 || chunk.size() > 0 || deflate > 0 || shuffle || szip > 0 ||
+    fletcher32 || filter != H5Z_FILTER_NONE || scale_offset >= 0;
 }
 
-// ------------------------ read size of the data (total number of entries) ------------------------
+// ------------------------------------- data-type in the file -------------------------------------
 
-inline size_t File::size(std::string path)
+inline H5::DataType DataSetOptions::storageType(const H5::DataType &type) const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::size: dataset not found ('"+path+"')");
+  if ( storage.getId() != H5I_INVALID_HID && storage.getClass() == type.getClass() )
+    return fileType(storage);
 
-  // return size
-  return static_cast<size_t>(m_file.openDataSet(path.c_str()).getSpace().getSelectNpoints());
+  return fileType(type);
 }
 
-// ------------------------------------ read shape of the data -------------------------------------
+// ------------------------------------------ set filters ------------------------------------------
 
-inline std::vector<size_t> File::shape(std::string path)
+inline void DataSetOptions::setFilters(H5::DSetCreatPropList &plist,
+  const H5::DataType &type) const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::shape: dataset not found ('"+path+"')");
+  // quantization
+  if ( scale_offset >= 0 && type.getId() != H5I_INVALID_HID )
+  {
+    herr_t status = 0;
 
-  // open data-space
-  H5::DataSpace dataspace = m_file.openDataSet(path.c_str()).getSpace();
+    if ( type.getClass() == H5T_FLOAT )
+      status = H5Pset_scaleoffset(plist.getId(), H5Z_SO_FLOAT_DSCALE, scale_offset);
+    else if ( type.getClass() == H5T_INTEGER )
+      status = H5Pset_scaleoffset(plist.getId(), H5Z_SO_INT, scale_offset);
 
-  // get the size in each direction
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - allocate as HDF5-type
-  std::vector<hsize_t> dimsf(rank);
-  // - allocate as vector
-  std::vector<size_t> shape(rank);
-  // - read
-  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
-  // - convert to vector
-  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+    if ( status < 0 )
+      throw std::runtime_error("HDF5pp::DataSetOptions: scale_offset not supported");
+  }
 
-  return shape;
+  // pre-conditioning
+  if ( shuffle ) plist.setShuffle();
+
+  // compression
+  if ( deflate > 0 ) plist.setDeflate(deflate);
+
+  if ( szip > 0 ) plist.setSzip(H5_SZIP_NN_OPTION_MASK, szip);
+
+  if ( filter != H5Z_FILTER_NONE )
+    plist.setFilter(filter, H5Z_FLAG_MANDATORY, filter_values.size(), filter_values.data());
+
+  // checksum (of the compressed data)
+  if ( fletcher32 ) plist.setFletcher32();
 }
 
-// ------------------------- read shape of the data along a specific axis --------------------------
+// -------------------------------- dataset creation property list ---------------------------------
 
-inline size_t File::shape(std::string path, size_t i)
+inline H5::DSetCreatPropList DataSetOptions::plist(const std::vector<size_t> &shape,
+  size_t itemsize, const H5::DataType &type) const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::shape: dataset not found ('"+path+"')");
+  H5::DSetCreatPropList out;
 
-  // open dataset
-  H5::DataSet   dataset   = m_file.openDataSet(path.c_str());
-  H5::DataSpace dataspace = dataset.getSpace();
+  // contiguous storage, or compact storage for small datasets
+  if ( shape.size() == 0 || !chunked() )
+  {
+    size_t nbytes = itemsize;
 
-  // get the size in each direction
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - check rank
-  if ( rank < static_cast<int>(i) )
-    throw std::runtime_error("HDF5pp::shape: rank too low ('"+path+"')");
-  // - allocate as HDF5-type
-  std::vector<hsize_t> dimsf(rank);
-  // - read
-  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
+    for ( auto &i : shape ) nbytes *= i;
 
-  return static_cast<size_t>(dimsf[i]);
+    if ( nbytes > 0 && nbytes <= compact ) out.setLayout(H5D_COMPACT);
+
+    return out;
+  }
+
+  // chunk shape: specified, or automatic
+  std::vector<hsize_t> chunk_shape;
+
+  if ( chunk.size() > 0 )
+  {
+    if ( chunk.size() != shape.size() )
+      throw std::runtime_error("HDF5pp: chunk shape does not match the rank of the dataset");
+
+    chunk_shape.assign(chunk.begin(), chunk.end());
+  }
+  else
+  {
+    chunk_shape = autoChunk(shape, itemsize);
+  }
+
+  // enable chunking and filters
+  out.setChunk(static_cast<int>(chunk_shape.size()), chunk_shape.data());
+
+  setFilters(out, type);
+
+  return out;
 }
 
-// ----------------------- read the size of the data in an opened dataset ------------------------
+// ====================================== ASYNCHRONOUS WRITER ======================================
 
-inline size_t File::size(const H5::DataSet &dataset)
+// ------------------------------------------ constructor ------------------------------------------
+
+inline AsyncWriter::AsyncWriter(size_t max_pending) :
+  m_max_pending(std::max(max_pending, static_cast<size_t>(1))), m_thread([this]{ run(); })
 {
-  return static_cast<size_t>(dataset.getSpace().getSelectNpoints());
 }
 
-// ----------------------- read the size of the data in an opened data-space -----------------------
+// ------------------------------------------ destructor -------------------------------------------
 
-inline size_t File::size(const H5::DataSpace &dataspace)
+inline AsyncWriter::~AsyncWriter()
 {
-  return static_cast<size_t>(dataspace.getSelectNpoints());
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_queued.notify_all();
+
+  m_thread.join();
 }
 
-// ------------------------ read the shape of the data in an opened dataset ------------------------
+// -------------------------------------------- submit ---------------------------------------------
 
-inline std::vector<size_t> File::shape(const H5::DataSet &dataset)
+inline std::future<void> AsyncWriter::push(std::function<void()> fn)
 {
-  // read the data-space
-  H5::DataSpace dataspace = dataset.getSpace();
+  auto promise = std::make_shared<std::promise<void>>();
 
-  // get the size in each direction
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - allocate as HDF5-type
-  std::vector<hsize_t> dimsf(rank);
-  // - allocate as vector
-  std::vector<size_t> shape(rank);
-  // - read
-  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
-  // - convert to vector
-  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+  std::future<void> out = promise->get_future();
 
-  return shape;
+  // operation: store its result in the future, remember the first exception
+  // NB "fn" is moved (not copied), as it may hold the data of the write
+  auto task = [this, promise, fn = std::move(fn)]()
+  {
+    try
+    {
+      fn();
+      promise->set_value();
+    }
+    catch (...)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( !m_error ) m_error = std::current_exception();
+      }
+
+      promise->set_exception(std::current_exception());
+    }
+  };
+
+  // queue, wait for space if needed
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_done.wait(lock, [this]{ return m_queue.size() < m_max_pending; });
+
+    m_queue.push_back(std::move(task));
+  }
+
+  m_queued.notify_all();
+
+  return out;
 }
 
-// ---------------------- read the shape of the data in an opened data-space -----------------------
+// --------------------------------------------- wait ----------------------------------------------
 
-inline std::vector<size_t> File::shape(const H5::DataSpace &dataspace)
+inline void AsyncWriter::wait()
 {
-  // get the size in each direction
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - allocate as HDF5-type
-  std::vector<hsize_t> dimsf(rank);
-  // - allocate as vector
-  std::vector<size_t> shape(rank);
-  // - read
-  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
-  // - convert to vector
-  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+  std::unique_lock<std::mutex> lock(m_mutex);
 
-  return shape;
+  m_done.wait(lock, [this]{ return m_queue.empty() && !m_busy; });
 }
 
-// ============================= WRITE STD::STRING TO SEPARATE DATASET =============================
+// -------------------------------------------- rethrow --------------------------------------------
 
-inline void File::write(std::string path, std::string input)
+inline void AsyncWriter::rethrow()
 {
-  // check existence of path
-  if ( exists(path) )
-    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
-
-  // create group(s) if needed
-  createGroup(path);
+  std::exception_ptr error;
 
-  // set data-type and data-space
-  H5::StrType   datatype(0, H5T_VARIABLE);
-  H5::DataSpace dataspace(H5S_SCALAR);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(error, m_error);
+  }
 
-  // create dataset
-  H5::DataSet dataset = m_file.createDataSet(path.c_str(), datatype, dataspace);
+  if ( error ) std::rethrow_exception(error);
+}
 
-  // write string to dataset
-  dataset.write(input, datatype, dataspace);
+// ------------------------------------ check if worker thread -------------------------------------
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
+inline bool AsyncWriter::isWorker() const
+{
+  return std::this_thread::get_id() == m_thread.get_id();
 }
 
-// =================== READ STD::STRING FROM DATASET THAT ONLY CONTAINS A STRING ===================
+// ---------------------------------------------- run ----------------------------------------------
 
-template<>
-inline std::string File::read<std::string>(std::string path)
+inline void AsyncWriter::run()
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+  while ( true )
+  {
+    std::function<void()> task;
 
-  // open dataset, get data-type
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+    // - take the next operation (stop when the queue is empty, and stopping is requested)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
 
-  // allocate output
-  std::string out;
+      m_queued.wait(lock, [this]{ return m_stop || !m_queue.empty(); });
 
-  // read output
-  dataset.read(out, dataset.getStrType(), dataset.getSpace());
+      if ( m_queue.empty() ) return;
 
-  return out;
-}
+      task = std::move(m_queue.front());
 
-// ================= CHECK IF DATASET HAS A PRECISION THAT MATCHES A SPECIFIC TYPE =================
+      m_queue.pop_front();
 
-// ---------------------------------------------- int ----------------------------------------------
+      m_busy = true;
+    }
 
-template<>
-inline bool File::correct_presision<int>(const H5::DataSet &dataset)
-{
-  // check data-type
-  if ( dataset.getTypeClass() != H5T_INTEGER ) return false;
+    // - execute (the operation stores its own exception)
+    task();
 
-  // check the number of bytes
-  if ( dataset.getIntType().getSize() != sizeof(int) ) return false;
+    // - signal completion
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_busy = false;
+    }
 
-  return true;
+    m_done.notify_all();
+  }
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// ============================= MULTI-THREADED CHUNK (DE)COMPRESSION ==============================
 
-template<>
-inline bool File::correct_presision<size_t>(const H5::DataSet &dataset)
-{
-  // check data-type
-  if ( dataset.getTypeClass() != H5T_INTEGER ) return false;
+#ifdef HDF5PP_ZLIB
 
-  // check the number of bytes
-  if ( dataset.getIntType().getSize() != sizeof(size_t) ) return false;
+// ------------------------------------------ (un)shuffle ------------------------------------------
 
-  return true;
-}
+inline std::vector<char> shuffleBytes(const std::vector<char> &data, size_t itemsize, bool shuffle)
+{
+  std::vector<char> out(data.size());
 
-// --------------------------------------------- float ---------------------------------------------
+  size_t n = data.size() / itemsize;
 
-template<>
-inline bool File::correct_presision<float>(const H5::DataSet &dataset)
-{
-  // check data-type
-  if ( dataset.getTypeClass() != H5T_FLOAT ) return false;
+  for ( size_t i = 0 ; i < n ; ++i )
+    for ( size_t j = 0 ; j < itemsize ; ++j )
+      if ( shuffle ) out[j*n+i] = data[i*itemsize+j];
+      else           out[i*itemsize+j] = data[j*n+i];
 
-  // check the number of bytes
-  if ( dataset.getFloatType().getSize() != sizeof(float) ) return false;
+  // trailing bytes (if any) are not shuffled
+  std::copy(data.begin()+n*itemsize, data.end(), out.begin()+n*itemsize);
 
-  return true;
+  return out;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// ------------------------------ copy chunk from/to the entire data -------------------------------
 
-template<>
-inline bool File::correct_presision<double>(const H5::DataSet &dataset)
+inline void copyChunk(char *data, char *chunk, const ChunkPipeline &pipe,
+  const std::vector<hsize_t> &offset, bool to_data)
 {
-  // check data-type
-  if ( dataset.getTypeClass() != H5T_FLOAT ) return false;
+  size_t rank = pipe.shape.size();
 
-  // check the number of bytes
-  if ( dataset.getFloatType().getSize() != sizeof(double) ) return false;
+  // shape of the part of the chunk that lies within the dataset
+  std::vector<hsize_t> extent(rank);
 
-  return true;
-}
+  for ( size_t i = 0 ; i < rank ; ++i )
+    extent[i] = std::min(pipe.chunk[i], pipe.shape[i]-offset[i]);
 
-// ================================ WRITE SCALAR TO SCALAR DATASET =================================
+  // copy contiguous rows (along the last axis), for each index along the other axes
+  size_t nbytes = extent[rank-1] * pipe.itemsize;
 
-// ------------------------------------------- template --------------------------------------------
+  std::vector<hsize_t> index(rank, 0);
 
-template<typename T>
-inline void File::write(std::string path, T input, const H5::PredType& HT)
-{
-  // check existence of path
-  if ( exists(path) )
-    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
+  while ( true )
+  {
+    // - position in the data and in the chunk
+    size_t idata = 0, ichunk = 0;
 
-  // create group(s) if needed
-  createGroup(path);
+    for ( size_t i = 0 ; i < rank ; ++i )
+    {
+      idata  = idata  * pipe.shape[i] + offset[i] + index[i];
+      ichunk = ichunk * pipe.chunk[i] + index[i];
+    }
 
-  // define data-type, force little-endian storage
-  auto datatype(HT);
-  datatype.setOrder(H5T_ORDER_LE);
+    // - copy
+    if ( to_data ) std::memcpy(data + idata*pipe.itemsize, chunk + ichunk*pipe.itemsize, nbytes);
+    else           std::memcpy(chunk + ichunk*pipe.itemsize, data + idata*pipe.itemsize, nbytes);
 
-  // add dataset to file
-  H5::DataSet dataset = m_file.createDataSet(path.c_str(), datatype, H5::DataSpace(H5S_SCALAR));
+    // - next row
+    int i = static_cast<int>(rank) - 2;
 
-  // store data
-  dataset.write(&input, HT);
+    for ( ; i >= 0 ; --i )
+    {
+      if ( ++index[i] < extent[i] ) break;
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
+      index[i] = 0;
+    }
+
+    if ( i < 0 ) break;
+  }
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// ----------------------------------------- encode chunk ------------------------------------------
 
-inline void File::write(std::string path, int input)
+inline std::vector<char> encodeChunk(std::vector<char> data, const ChunkPipeline &pipe)
 {
-  return write<int>(path,input,H5::PredType::NATIVE_INT);
-}
+  for ( size_t i = 0 ; i < pipe.filters.size() ; ++i )
+  {
+    if ( pipe.filters[i] == H5Z_FILTER_SHUFFLE )
+    {
+      data = shuffleBytes(data, pipe.itemsize, true);
+    }
+    else
+    {
+      uLongf            nbytes = compressBound(data.size());
+      std::vector<char> out(nbytes);
 
-// -------------------------------------------- size_t ---------------------------------------------
+      if ( compress2(reinterpret_cast<Bytef*>(out.data()), &nbytes,
+        reinterpret_cast<const Bytef*>(data.data()), data.size(), pipe.level[i]) != Z_OK )
+          throw std::runtime_error("HDF5pp: deflate failed");
 
-inline void File::write(std::string path, size_t input)
-{
-  return write<size_t>(path,input,H5::PredType::NATIVE_HSIZE);
-}
+      out.resize(nbytes);
 
-// --------------------------------------------- float ---------------------------------------------
+      data = std::move(out);
+    }
+  }
 
-inline void File::write(std::string path, float input)
-{
-  return write<float>(path,input,H5::PredType::NATIVE_FLOAT);
+  return data;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// ----------------------------------------- decode chunk ------------------------------------------
 
-inline void File::write(std::string path, double input)
+inline std::vector<char> decodeChunk(std::vector<char> data, const ChunkPipeline &pipe,
+  uint32_t mask)
 {
-  return write<double>(path,input,H5::PredType::NATIVE_DOUBLE);
-}
+  // number of bytes in a chunk
+  size_t nbytes = pipe.itemsize;
 
-// ============================== OVERWRITE SCALAR TO SCALAR DATASET ===============================
+  for ( auto &i : pipe.chunk ) nbytes *= i;
 
-// ------------------------------------------- template --------------------------------------------
+  // undo filters in reverse order, except those that were skipped when writing
+  for ( size_t i = pipe.filters.size() ; i-- > 0 ; )
+  {
+    if ( mask & (1u << i) ) continue;
 
-template<typename T>
-inline void File::overwrite(std::string path, T input, const H5::PredType& HT)
-{
-  // new dataset: write using normal function
-  if ( ! exists(path) ) return write<T>(path,input,HT);
+    if ( pipe.filters[i] == H5Z_FILTER_SHUFFLE )
+    {
+      data = shuffleBytes(data, pipe.itemsize, false);
+    }
+    else
+    {
+      uLongf            n = nbytes;
+      std::vector<char> out(nbytes);
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(m_file.openDataSet(path.c_str())) )
-      throw std::runtime_error("HDF5pp::overwrite: precision inconsistent ('"+path+"')");
-  #endif
+      if ( uncompress(reinterpret_cast<Bytef*>(out.data()), &n,
+        reinterpret_cast<const Bytef*>(data.data()), data.size()) != Z_OK || n != nbytes )
+          throw std::runtime_error("HDF5pp: inflate failed");
 
-  // check size
-  if ( size(path) != 1 )
-    throw std::runtime_error("HDF5pp::overwrite: dataset has a rank different than 1 ('"+path+"')");
+      data = std::move(out);
+    }
+  }
 
-  // open dataset
-  H5::DataSet *dataset = new H5::DataSet(m_file.openDataSet(path.c_str()));
+  if ( data.size() != nbytes )
+    throw std::runtime_error("HDF5pp: chunk size inconsistent");
 
-  // store data
-  dataset->write(&input, HT);
+  return data;
+}
 
-  // clean-up
-  delete dataset;
+#endif
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
-}
+// ========================================= FILE OPTIONS ==========================================
 
-// ---------------------------------------------- int ----------------------------------------------
+// ---------------------------------- file creation property list ----------------------------------
 
-inline void File::overwrite(std::string path, int input)
+inline H5::FileCreatPropList FileOptions::createPlist() const
 {
-  return overwrite<int>(path,input,H5::PredType::NATIVE_INT);
-}
+  H5::FileCreatPropList out;
 
-// -------------------------------------------- size_t ---------------------------------------------
+  // storage of the links of the root group (other groups: see "File::createGroup")
+  if ( max_compact > 0 || min_dense > 0 )
+    if ( H5Pset_link_phase_change(out.getId(), max_compact ? max_compact : 8,
+                                  min_dense ? min_dense : 6) < 0 )
+      throw std::runtime_error("HDF5pp::FileOptions: invalid max_compact/min_dense");
 
-inline void File::overwrite(std::string path, size_t input)
-{
-  return overwrite<size_t>(path,input,H5::PredType::NATIVE_HSIZE);
+  // paged allocation
+  if ( page_size > 0 )
+  {
+    #if H5_VERSION_GE(1,10,1)
+      if ( H5Pset_file_space_strategy(out.getId(), H5F_FSPACE_STRATEGY_PAGE, 0, 1) < 0 ||
+           H5Pset_file_space_page_size(out.getId(), static_cast<hsize_t>(page_size)) < 0 )
+        throw std::runtime_error("HDF5pp::FileOptions: invalid page_size");
+    #else
+      throw std::runtime_error("HDF5pp::FileOptions: page_size requires HDF5 >= 1.10.1");
+    #endif
+  }
+
+  return out;
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// ----------------------------------- file access property list -----------------------------------
 
-inline void File::overwrite(std::string path, float input)
+inline H5::FileAccPropList FileOptions::accessPlist() const
 {
-  return overwrite<float>(path,input,H5::PredType::NATIVE_FLOAT);
-}
+  H5::FileAccPropList out;
 
-// -------------------------------------------- double ---------------------------------------------
+  if ( meta_block_size > 0 )
+  {
+    hsize_t size = static_cast<hsize_t>(meta_block_size);
+    out.setMetaBlockSize(size);
+  }
 
-inline void File::overwrite(std::string path, double input)
-{
-  return overwrite<double>(path,input,H5::PredType::NATIVE_DOUBLE);
-}
+  if ( latest_format ) out.setLibverBounds(H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
 
-// ======================== READ SCALAR FROM DATASET (SCALAR, OR OF SIZE 1) ========================
+  // alignment
+  if ( alignment > 1 )
+    out.setAlignment(static_cast<hsize_t>(alignment_threshold), static_cast<hsize_t>(alignment));
 
-// ------------------------------------------- template --------------------------------------------
+  // chunk cache (the first argument is ignored by HDF5)
+  if ( chunk_cache_bytes > 0 || chunk_cache_slots > 0 || chunk_cache_w0 >= 0.0 )
+  {
+    int    mdc;
+    size_t nslots, nbytes;
+    double w0;
 
-template<typename T>
-inline T File::read_scalar(std::string path, const H5::PredType& HT)
-{
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+    out.getCache(mdc, nslots, nbytes, w0);
 
-  // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+    if ( chunk_cache_bytes > 0   ) nbytes = chunk_cache_bytes;
+    if ( chunk_cache_slots > 0   ) nslots = chunk_cache_slots;
+    if ( chunk_cache_w0    >= 0. ) w0     = chunk_cache_w0;
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
-  #endif
+    out.setCache(mdc, nslots, nbytes, w0);
+  }
 
-  // check size
-  if ( this->size(dataset) > 1 )
-    throw std::runtime_error("HDF5pp::read: dataset has a rank different than 1 ('"+path+"')");
+  // metadata cache
+  if ( metadata_cache > 0 )
+  {
+    H5AC_cache_config_t config;
 
-  // allocate output
-  T out;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
 
-  // read output
-  dataset.read(&out, HT);
+    if ( H5Pget_mdc_config(out.getId(), &config) < 0 )
+      throw std::runtime_error("HDF5pp::FileOptions: cannot read the metadata cache settings");
+
+    config.set_initial_size = true;
+    config.initial_size     = metadata_cache;
+    config.min_size         = std::min(config.min_size, metadata_cache);
+    config.max_size         = std::max(config.max_size, metadata_cache);
+
+    if ( H5Pset_mdc_config(out.getId(), &config) < 0 )
+      throw std::runtime_error("HDF5pp::FileOptions: invalid metadata_cache");
+  }
+
+  // page buffer
+  if ( page_buffer_size > 0 )
+  {
+    #if H5_VERSION_GE(1,10,1)
+      if ( H5Pset_page_buffer_size(out.getId(), page_buffer_size, 0, 0) < 0 )
+        throw std::runtime_error("HDF5pp::FileOptions: invalid page_buffer_size");
+    #else
+      throw std::runtime_error("HDF5pp::FileOptions: page_buffer_size requires HDF5 >= 1.10.1");
+    #endif
+  }
+
+  // driver
+  if ( driver == Core )
+  {
+    out.setCore(core_increment ? core_increment : 1024*1024, core_write_back);
+  }
+  else if ( driver == Direct )
+  {
+    #ifdef H5_HAVE_DIRECT
+      if ( H5Pset_fapl_direct(out.getId(), 4096, 4096, 16*1024*1024) < 0 )
+        throw std::runtime_error("HDF5pp::FileOptions: cannot use the direct I/O driver");
+    #else
+      throw std::runtime_error("HDF5pp: the direct I/O driver is not available");
+    #endif
+  }
 
   return out;
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------- presets --------------------------------------------
 
-template<>
-inline int File::read<int>(std::string path)
+inline FileOptions FileOptions::manySmallDatasets()
 {
-  return read_scalar<int>(path,H5::PredType::NATIVE_INT);
+  FileOptions out;
+
+  out.latest_format   = true;
+  out.meta_block_size = 64*1024;
+  out.metadata_cache  = 16*1024*1024;
+
+  return out;
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline size_t File::read<size_t>(std::string path)
+inline FileOptions FileOptions::fewHugeArrays()
 {
-  return read_scalar<size_t>(path,H5::PredType::NATIVE_HSIZE);
+  FileOptions out;
+
+  out.alignment           = 4096;
+  out.alignment_threshold = 1024*1024;
+  out.chunk_cache_bytes   = 64*1024*1024;
+  out.chunk_cache_slots   = 12421;
+
+  return out;
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline float File::read<float>(std::string path)
+inline FileOptions FileOptions::streamingAppend()
 {
-  return read_scalar<float>(path,H5::PredType::NATIVE_FLOAT);
+  FileOptions out;
+
+  out.latest_format     = true;
+  out.chunk_cache_bytes = 16*1024*1024;
+  out.chunk_cache_slots = 2053;
+  out.chunk_cache_w0    = 1.0;
+
+  return out;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline double File::read<double>(std::string path)
+inline FileOptions FileOptions::inMemory(bool write_back)
 {
-  return read_scalar<double>(path,H5::PredType::NATIVE_DOUBLE);
+  FileOptions out;
+
+  out.driver          = Core;
+  out.core_write_back = write_back;
+
+  return out;
 }
 
-// ========================= WRITE SCALAR TO EXTENDABLE DATASET OF RANK 1 ==========================
+// ========================================= CONSTRUCTORS ==========================================
 
-// ------------------------------------------- template --------------------------------------------
+inline File::File(const std::string &name, const std::string &mode, bool autoflush) :
+  File(name, mode, autoflush ? FlushPolicy::always() : FlushPolicy::checkpoint())
+{
+}
 
-template<typename T>
-inline void File::write(std::string path, T input, const H5::PredType& HT,
-  size_t index, T fill_val, size_t chunk_size
-)
+// -------------------------------------------------------------------------------------------------
+
+inline File::File(const std::string &name, const std::string &mode, const FlushPolicy &policy)
 {
-  // initialize if needed
-  // --------------------
+  // copy filename
+  m_fname = name;
 
-  if ( !exists(path) )
-  {
-    // create group(s) if needed
-    createGroup(path);
+  // open file
+  open(mode, H5::FileCreatPropList::DEFAULT, H5::FileAccPropList::DEFAULT);
 
-    // set rank
-    int rank = 1;
+  // store flush settings
+  m_flush = policy;
+}
 
-    // set initial and maximum shape of the array, and initial offset
-    // NB initially an array of size "index+1" will be written, filled with "fill_val" and "input"
-    std::vector<hsize_t> shape(rank, index+1), max_shape(rank, H5S_UNLIMITED), offset(rank, 0);
+// -------------------------------------------------------------------------------------------------
 
-    // define the data-space
-    H5::DataSpace dataspace(rank, shape.data(), max_shape.data());
+inline File::File(const std::string &name, const std::string &mode, const FileOptions &options,
+  const FlushPolicy &policy)
+{
+  // copy filename, store options
+  m_fname        = name;
+  m_file_options = options;
 
-    // choose chunk size (chosen by the user, who knows what to expect)
-    std::vector<hsize_t> chunk_shape(rank, static_cast<hsize_t>(chunk_size));
+  // open file
+  open(mode, options.createPlist(), options.accessPlist());
 
-    // enable chunking
-    H5::DSetCreatPropList chunk_param;
-    chunk_param.setChunk(rank, chunk_shape.data());
-    chunk_param.setFillValue(HT, &fill_val);
+  // store flush settings
+  m_flush = policy;
+}
 
-    // create new dataset
-    H5::DataSet dataset = m_file.createDataSet(path.c_str(), HT, dataspace, chunk_param);
+// -------------------------------------------------------------------------------------------------
 
-    // make sure that the dataset is at least what we expect
-    dataset.extend(shape.data());
+inline File::File(const std::vector<char> &image, const std::string &mode,
+  const FlushPolicy &policy)
+{
+  // unique name: the core driver identifies files without backing store by their name
+  static std::atomic<size_t> count(0);
 
-    // select the hyperslap
-    H5::DataSpace fspace = dataset.getSpace();
-    fspace.selectHyperslab(H5S_SELECT_SET, shape.data(), offset.data());
+  m_fname = "HDF5pp-image-" + std::to_string(count++);
 
-    // initial data, filled with "fill_val" and with "input" at "init_data[index]"
-    std::vector<T> init_data(index+1, fill_val);
-    init_data[index] = input;
+  // check the image
+  if ( image.empty() ) throw std::runtime_error("HDF5pp: empty file image");
 
-    // write data to the hyperslap
-    dataset.write(init_data.data(), HT, dataspace, fspace);
+  // keep the file in memory, using a copy of the image
+  m_file_options = FileOptions::inMemory(false);
 
-    // flush the file if so requested
-    if ( m_autoflush ) flush();
+  H5::FileAccPropList access = m_file_options.accessPlist();
 
-    // quit function
-    return;
-  }
+  if ( H5Pset_file_image(access.getId(), const_cast<char*>(image.data()), image.size()) < 0 )
+    throw std::runtime_error("HDF5pp: unable to set the file image");
 
-  // extend
-  // ------
+  // open file
+  if      ( mode == "r"                ) m_file = H5::H5File(m_fname.c_str(), H5F_ACC_RDONLY,
+                                           H5::FileCreatPropList::DEFAULT, access);
+  else if ( mode == "a" or mode == "r+" ) m_file = H5::H5File(m_fname.c_str(), H5F_ACC_RDWR,
+                                           H5::FileCreatPropList::DEFAULT, access);
+  else throw std::runtime_error("HDF5pp: unknown mode '"+mode+"' for a file image");
 
-  // open dataset
-  H5::DataSet   dataset   = m_file.openDataSet(path.c_str());
-  H5::DataSpace dataspace = dataset.getSpace();
+  // store flush settings
+  m_flush = policy;
+}
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::write: precision inconsistent ('"+path+"')");
-  #endif
+// -------------------------------------------------------------------------------------------------
 
-  // get the current rank and shape
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - allocate shape as HDF5-type
-  std::vector<hsize_t> shape(rank);
-  // - read shape
-  dataspace.getSimpleExtentDims(shape.data(), NULL);
+#ifdef HDF5PP_MPI
 
-  // check rank (here only simple arrays are supported)
-  if ( rank != 1 )
-    throw std::runtime_error("HDF5pp::write: can only extend rank 1 array ('"+path+"')");
+inline File::File(const std::string &name, const std::string &mode, MPI_Comm comm,
+  MPI_Info info, const FlushPolicy &policy)
+{
+  // copy filename
+  m_fname = name;
 
-  // extend shape, if needed
-  shape[0] = std::max(static_cast<size_t>(shape[0]), index+1);
+  // store communicator
+  m_mpi  = true;
+  m_comm = comm;
 
-  // process extension
-  dataset.extend(shape.data());
+  // open file using MPI-IO
+  H5::FileAccPropList access;
 
-  // set offset
-  std::vector<hsize_t> offset(rank, index);
+  if ( H5Pset_fapl_mpio(access.getId(), comm, info) < 0 )
+    throw std::runtime_error("HDF5pp::File: cannot use MPI-IO ('"+name+"')");
 
-  // pseudo-shape of the array
-  std::vector<hsize_t> extra_shape(rank, 1);
+  open(mode, H5::FileCreatPropList::DEFAULT, access);
 
-  // define the extra data-space
-  H5::DataSpace extra_datasape(rank, extra_shape.data());
+  // writes to slices are collective
+  if ( H5Pset_dxpl_mpio(m_xfer.getId(), H5FD_MPIO_COLLECTIVE) < 0 )
+    throw std::runtime_error("HDF5pp::File: cannot use collective MPI-IO ('"+name+"')");
 
-  // select a hyperslap
-  H5::DataSpace fspace = dataset.getSpace();
-  fspace.selectHyperslab(H5S_SELECT_SET, extra_shape.data(), offset.data());
+  // store flush settings
+  setFlushPolicy(policy);
+}
 
-  // write data to the hyperslap
-  dataset.write(&input, HT, extra_datasape, fspace);
+#endif
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
+// -------------------------------------------------------------------------------------------------
+
+inline void File::open(const std::string &mode_, const H5::FileCreatPropList &create,
+  const H5::FileAccPropList &access)
+{
+  // copy mode
+  std::string mode = mode_;
+
+  // check if the file exists
+  if ( mode == "r" )
+  {
+     // - find file
+    std::ifstream infile(m_fname);
+    // - throw error if file does not exist
+    if ( ! infile.good() ) std::runtime_error("HDF5pp: file does not exist ('"+m_fname+"')");
+  }
+
+  // check if file exists, otherwise set write mode to "w"
+  if ( mode == "a" or mode == "r+" )
+  {
+    // - find file
+    std::ifstream infile(m_fname);
+    // - change write mode if file does not exist
+    if ( ! infile.good() ) mode = "w";
+  }
+
+  // open file
+  if      ( mode == "r"         ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_RDONLY,create,access);
+  else if ( mode == "w"         ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_TRUNC ,create,access);
+  else if ( mode == "a" or "r+" ) m_file = H5::H5File(m_fname.c_str(),H5F_ACC_RDWR  ,create,access);
+  else throw std::runtime_error("HDF5pp: unknown mode '"+mode+"'");
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// ========================================== DESTRUCTOR ===========================================
 
-inline void File::write(
-  std::string path, int input, size_t index, int fill_val, size_t chunk_size
-)
+inline File::~File()
 {
-  return write<int>(path,input,H5::PredType::NATIVE_INT,index,fill_val,chunk_size);
+  // finish asynchronous writes, write pending entries of extendable datasets
+  // NB a destructor may not throw: errors are ignored, call "flush()" to catch them
+  if ( m_async  ) m_async ->wait();
+  if ( m_reader ) m_reader->wait();
+
+  try { writePending(); } catch (...) {}
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// ======================================= SUPPORT FUNCTIONS =======================================
+
+// ---------------------------------------- return filename ----------------------------------------
 
-inline void File::write(
-  std::string path, size_t input, size_t index, size_t fill_val, size_t chunk_size
-)
+inline std::string File::fname() const
 {
-  return write<size_t>(path,input,H5::PredType::NATIVE_HSIZE,index,fill_val,chunk_size);
+  return m_fname;
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// ----------------------------------------- image of file -----------------------------------------
 
-inline void File::write(
-  std::string path, float input, size_t index, float fill_val, size_t chunk_size
-)
+inline std::vector<char> File::image()
 {
-  return write<float>(path,input,H5::PredType::NATIVE_FLOAT,index,fill_val,chunk_size);
+  // write everything to the file
+  flush();
+
+  // get size
+  ssize_t n = H5Fget_file_image(m_file.getId(), nullptr, 0);
+
+  if ( n < 0 ) throw std::runtime_error("HDF5pp::image: cannot get the file image ('"+m_fname+"')");
+
+  // copy image
+  std::vector<char> out(static_cast<size_t>(n));
+
+  if ( H5Fget_file_image(m_file.getId(), out.data(), out.size()) != n )
+    throw std::runtime_error("HDF5pp::image: cannot get the file image ('"+m_fname+"')");
+
+  return out;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// ------------------------------------------ flush file -------------------------------------------
 
-inline void File::write(
-  std::string path, double input, size_t index, double fill_val, size_t chunk_size
-)
+inline void File::flush()
 {
-  return write<double>(path,input,H5::PredType::NATIVE_DOUBLE,index,fill_val,chunk_size);
+  // finish asynchronous writes
+  drain();
+
+  // write pending entries of extendable datasets
+  writePending();
+
+  // flush
+  flushFile();
 }
 
-// ============================== READ SCALAR FROM DATASET OF RANK 1 ===============================
+// -------------------------------------- asynchronous writes --------------------------------------
 
-// ------------------------------------------- template --------------------------------------------
+inline void File::setAsync(bool async, size_t max_pending)
+{
+  // finish reading blocks
+  if ( m_reader ) m_reader->wait();
 
-template<typename T>
-inline T File::read(std::string path, const H5::PredType& HT, size_t index)
+  // finish the writes of the current background thread, stop it
+  if ( m_async )
+  {
+    m_async->wait();
+
+    std::shared_ptr<AsyncWriter> writer = std::move(m_async);
+
+    writer->rethrow();
+  }
+
+  // start a new background thread
+  if ( async ) m_async = std::make_shared<AsyncWriter>(max_pending);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+inline bool File::async() const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+  return static_cast<bool>(m_async);
+}
 
-  // open dataset
-  H5::DataSet   dataset   = m_file.openDataSet(path.c_str());
-  H5::DataSpace dataspace = dataset.getSpace();
+// -------------------------------------------------------------------------------------------------
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::read: incorrect precision ('"+path+"')");
-  #endif
+inline void File::drain()
+{
+  // finish reading blocks, see "iterate"
+  if ( m_reader && !m_reader->isWorker() ) m_reader->wait();
 
-  // get the current rank and shape
-  // - read rank (a.k.a number of dimensions)
-  int rank = dataspace.getSimpleExtentNdims();
-  // - allocate shape as HDF5-type
-  std::vector<hsize_t> shape(rank);
-  // - read shape
-  dataspace.getSimpleExtentDims(shape.data(), NULL);
+  if ( !m_async || m_async->isWorker() ) return;
 
-  // check rank (here only simple arrays are supported)
-  if ( rank != 1 )
-    throw std::runtime_error("HDF5pp::read: dataset not rank 1 ('"+path+"')");
+  m_async->wait();
 
-  // check the shape
-  if ( index >= shape[0] )
-    throw std::runtime_error("HDF5pp::read: index out-of-bounds ('"+path+"')");
+  m_async->rethrow();
+}
 
-  // set offset
-  std::vector<hsize_t> offset(rank, index);
+// -------------------------------------------------------------------------------------------------
 
-  // pseudo-shape of the array
-  std::vector<hsize_t> extra_shape(rank, 1);
+inline void File::waitAsync() const
+{
+  if ( m_async  && !m_async ->isWorker() ) m_async ->wait();
+  if ( m_reader && !m_reader->isWorker() ) m_reader->wait();
+}
 
-  // define the extra data-space
-  H5::DataSpace extra_datasape(rank, extra_shape.data());
+// -------------------------------------------------------------------------------------------------
 
-  // select a hyperslap
-  H5::DataSpace fspace = dataset.getSpace();
-  fspace.selectHyperslab(H5S_SELECT_SET, extra_shape.data(), offset.data());
+inline std::shared_ptr<AsyncWriter> File::reader()
+{
+  if ( m_async ) return m_async;
 
-  // allocate output
-  T out;
+  if ( !m_reader ) m_reader = std::make_shared<AsyncWriter>(1);
 
-  // read data from the hyperslap
-  dataset.read(&out, HT, extra_datasape, fspace);
+  return m_reader;
+}
 
-  return out;
+// -------------------------------------------------------------------------------------------------
+
+template<class Fn, class... Args>
+inline std::future<void> File::submit(Fn fn, Args&&... args)
+{
+  // store the arguments by value (moving rvalues), call "fn" with them
+  auto task = [fn, data = std::make_tuple(std::forward<Args>(args)...)]() mutable
+  {
+    applyTuple(fn, data, std::index_sequence_for<Args...>());
+  };
+
+  // background thread: queue
+  if ( m_async ) return m_async->push(std::move(task));
+
+  // no background thread: execute now
+  std::promise<void> promise;
+
+  try
+  {
+    task();
+    promise.set_value();
+  }
+  catch (...)
+  {
+    promise.set_exception(std::current_exception());
+  }
+
+  return promise.get_future();
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline int File::read<int>(std::string path, size_t index)
+template<class... Args>
+inline std::future<void> File::write_async(std::string path, Args&&... args)
 {
-  return read<int>(path,H5::PredType::NATIVE_INT,index);
+  return submit([this, path](auto&... data){ this->write(path, data...); },
+    std::forward<Args>(args)...);
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline size_t File::read<size_t>(std::string path, size_t index)
+template<class... Args>
+inline std::future<void> File::overwrite_async(std::string path, Args&&... args)
 {
-  return read<size_t>(path,H5::PredType::NATIVE_HSIZE,index);
+  return submit([this, path](auto&... data){ this->overwrite(path, data...); },
+    std::forward<Args>(args)...);
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline float File::read<float>(std::string path, size_t index)
+template<class... Args>
+inline std::future<void> File::append_async(std::string path, Args&&... args)
 {
-  return read<float>(path,H5::PredType::NATIVE_FLOAT,index);
+  return submit([this, path](auto&... data){ this->append(path, data...); },
+    std::forward<Args>(args)...);
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// ------------------------------------------ checkpoint -------------------------------------------
 
-template<>
-inline double File::read<double>(std::string path, size_t index)
+inline void File::checkpoint()
 {
-  return read<double>(path,H5::PredType::NATIVE_DOUBLE,index);
+  if ( m_flush.mode != FlushPolicy::Never ) flush();
 }
 
-// ====================== TEMPLATE TO WRITE ARRAY OF ARBITRARY SHAPE OR RANK =======================
+// ----------------------------------------- flush policy ------------------------------------------
 
-template<typename T>
-inline void File::write(
-  std::string path, const T *input, const H5::PredType& HT, const std::vector<size_t> &shape
-)
+inline void File::setFlushPolicy(const FlushPolicy &policy)
 {
-  // check existence of path
-  if ( exists(path) )
-    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
+  waitAsync();
+
+  #ifdef HDF5PP_MPI
+    if ( m_mpi && ( policy.mode == FlushPolicy::Bytes || policy.mode == FlushPolicy::Seconds ) )
+      throw std::runtime_error("HDF5pp::setFlushPolicy: policy not allowed with MPI");
+  #endif
+
+  m_flush = policy;
+}
+
+inline FlushPolicy File::flushPolicy() const
+{
+  waitAsync();
 
+  return m_flush;
+}
+
+// --------------------------------------- flush statistics ----------------------------------------
+
+inline FlushStats File::flushStats() const
+{
+  waitAsync();
+
+  return m_flush_stats;
+}
+
+// ---------------------------------- create dataset for an array ----------------------------------
+
+inline H5::DataSet File::createArray(const std::string &path, const H5::DataType& HT,
+  const std::vector<size_t> &shape, const DataSetOptions &options, size_t itemsize)
+{
   // create group(s) if needed
   createGroup(path);
 
@@ -1152,186 +2493,3371 @@ inline void File::write(
   // - store shape in each direction
   for ( size_t i = 0 ; i < rank ; ++i )
     dimsf[i] = shape[i];
+  // - maximum shape, differs from the shape only for extendable arrays
+  std::vector<hsize_t> max_dimsf = dimsf;
+  // - store maximum shape in each direction
+  if ( options.max_shape.size() )
+  {
+    if ( options.max_shape.size() != rank )
+      throw std::runtime_error("HDF5pp::write: maximum shape inconsistent ('"+path+"')");
+
+    for ( size_t i = 0 ; i < rank ; ++i )
+      max_dimsf[i] = options.max_shape[i];
+  }
 
   // define data-type, force little-endian storage
-  auto datatype(HT);
-  datatype.setOrder(H5T_ORDER_LE);
+  H5::DataType datatype = options.storageType(HT);
 
   // define data-space
-  H5::DataSpace dataspace(rank, dimsf.data());
+  H5::DataSpace dataspace(rank, dimsf.data(), max_dimsf.data());
 
-  // add dataset to file
-  H5::DataSet dataset = m_file.createDataSet(path.c_str(), datatype, dataspace);
-
-  // store data
-  dataset.write(input, HT);
+  // add dataset to file (chunked and compressed if so requested)
+  // - no compact layout in a parallel file (see "DataSetOptions::compact")
+  #ifdef HDF5PP_MPI
+  if ( m_mpi && options.compact > 0 )
+  {
+    DataSetOptions opt = options;
+    opt.compact = 0;
+    return createDataSet(path, datatype, dataspace, opt.plist(shape, itemsize, datatype));
+  }
+  #endif
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
+  return createDataSet(path, datatype, dataspace, options.plist(shape, itemsize, datatype));
 }
 
-// ==================== TEMPLATE TO OVERWRITE ARRAY OF ARBITRARY SHAPE OR RANK =====================
+// --------------------------------------- storage of arrays ---------------------------------------
 
-template<typename T>
-inline void File::overwrite(
-  std::string path, const T *input, const H5::PredType& HT, const std::vector<size_t> &shape
-)
+inline void File::setDataSetOptions(const DataSetOptions &options)
 {
-  // new dataset: write using normal function
-  if ( ! exists(path) ) return write<T>(path,input,HT,shape);
+  waitAsync();
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(m_file.openDataSet(path.c_str())) )
-      throw std::runtime_error("HDF5pp::overwrite: precision inconsistent ('"+path+"')");
-  #endif
+  m_options = options;
+}
 
-  // check shape
-  if ( this->shape(path) != shape )
-    throw std::runtime_error("HDF5pp::overwrite: shape inconsistent ('"+path+"')");
+inline DataSetOptions File::dataSetOptions() const
+{
+  waitAsync();
 
-  // open dataset
-  H5::DataSet *dataset = new H5::DataSet(m_file.openDataSet(path.c_str()));
+  return m_options;
+}
 
-  // store data
-  dataset->write(input, HT);
+// ------------------------ flush the file, without writing pending entries ------------------------
 
-  // clean-up
-  delete dataset;
+inline void File::flushFile()
+{
+  waitAsync();
 
-  // flush the file if so requested
-  if ( m_autoflush ) flush();
-}
+  auto t0 = std::chrono::steady_clock::now();
 
-// ======================= WRITE STD::VECTOR TO DATASET (OF ARBITRARY RANK) ========================
+  m_file.flush(H5F_SCOPE_GLOBAL);
 
-// ------------------------------------------- template --------------------------------------------
+  m_flush_last          = std::chrono::steady_clock::now();
+  m_flush_writes        = 0;
+  m_flush_bytes         = 0;
+  m_flush_stats.flushes += 1;
+  m_flush_stats.time    += std::chrono::duration<double>(m_flush_last-t0).count();
+}
 
-template<typename T>
-inline void File::write(std::string path, const std::vector<T> &input, const H5::PredType& HT,
-  const std::vector<size_t> &shape)
+// ----------------------------- register write, flush if so requested -----------------------------
+
+inline void File::autoflush(size_t nbytes)
 {
-  // copy input shape
-  std::vector<size_t> dims = shape;
+  // update counters
+  m_flush_writes        += 1;
+  m_flush_bytes         += nbytes;
+  m_flush_stats.writes  += 1;
+  m_flush_stats.bytes   += nbytes;
+
+  // flush if the policy requires it (after the batch, if committing a batch)
+  if ( !m_batch && flushDue() ) flushFile();
+}
 
-  // default shape == size of input
-  if ( dims.size() == 0 )
+// ------------------------------ check if the policy requires flush -------------------------------
+
+inline bool File::flushDue() const
+{
+  switch ( m_flush.mode )
   {
-    dims.resize(1);
-    dims[0] = input.size();
+    case FlushPolicy::Always:
+      return m_flush_writes > 0;
+    case FlushPolicy::Writes:
+      return m_flush_writes >= m_flush.threshold;
+    case FlushPolicy::Bytes:
+      return m_flush_bytes >= m_flush.threshold;
+    case FlushPolicy::Seconds:
+      return std::chrono::duration<double>(std::chrono::steady_clock::now()-m_flush_last).count()
+        >= m_flush.threshold;
+    default:
+      return false;
   }
-
-  // write to file
-  write(path,input.data(),HT,dims);
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------- check if path exists (is group or dataset) ---------------------------
 
-inline void File::write(
-  std::string path, const std::vector<int> &input, const std::vector<size_t> &shape
-)
+inline bool File::exists(const std::string &path) const
 {
-  return write(path,input,H5::PredType::NATIVE_INT,shape);
+  // see all submitted asynchronous writes
+  waitAsync();
+
+  // extendable dataset with pending entries (its groups have been created)
+  if ( m_append.count(path) ) return true;
+
+  // known group, or open dataset
+  if ( m_groups.count(path) || m_cache.count(path) ) return true;
+
+  // find the parent group
+  size_t end = path.rfind("/");
+
+  // check all parent groups, unless the parent group is known to exist
+  if ( end != std::string::npos && end > 0 && !m_groups.count(path.substr(0,end)) )
+  {
+    // find first "/"
+    size_t idx = path.find("/");
+
+    // loop over all groups
+    while ( true )
+    {
+      // - terminate if all "/" have been found
+      if ( std::string::npos == idx ) break;
+      // - check group
+      if ( idx > 0 )
+      {
+        // -- get group name
+        std::string name(path.substr(0,idx));
+        // -- check if it exists, and store the result
+        if ( !m_groups.count(name) )
+        {
+          if ( !m_file.exists(name.c_str()) ) return false;
+          m_groups.insert(name);
+        }
+      }
+      // - proceed to next "/"
+      idx = path.find("/",idx+1);
+    }
+  }
+
+  return m_file.exists(path.c_str());
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// ---------------------------------------- create a group -----------------------------------------
 
-inline void File::write(
-  std::string path, const std::vector<size_t> &input, const std::vector<size_t> &shape
-)
+inline void File::createGroup(std::string path)
 {
-  return write(path,input,H5::PredType::NATIVE_HSIZE,shape);
-}
+  // see all submitted asynchronous writes
+  waitAsync();
 
-// --------------------------------------------- float ---------------------------------------------
+  // find the parent group, quit if it is known to exist
+  size_t end = path.rfind("/");
 
-inline void File::write(
-  std::string path, const std::vector<float> &input, const std::vector<size_t> &shape
-)
+  if ( end == std::string::npos || end == 0 || m_groups.count(path.substr(0,end)) ) return;
+
+  // find first "/"
+  size_t idx = path.find("/");
+
+  // loop over all groups
+  while ( true )
+  {
+    // - terminate if all "/" have been found
+    if ( std::string::npos == idx ) return;
+    // - create group if needed
+    if ( idx > 0 )
+    {
+      // -- get group name
+      std::string name(path.substr(0,idx));
+      // -- create if needed, and store that it exists
+      if ( !m_groups.count(name) )
+      {
+        if ( !m_file.exists(name.c_str()) )
+        {
+          if ( m_file_options.max_compact == 0 && m_file_options.min_dense == 0 )
+          {
+            H5::Group group = m_file.createGroup(name.c_str());
+          }
+          else
+          {
+            // storage of the links as specified
+            hid_t plist = H5Pcreate(H5P_GROUP_CREATE);
+
+            herr_t status = H5Pset_link_phase_change(plist,
+              m_file_options.max_compact ? m_file_options.max_compact : 8,
+              m_file_options.min_dense   ? m_file_options.min_dense   : 6);
+
+            if ( status < 0 )
+            {
+              H5Pclose(plist);
+              throw std::runtime_error(
+                "HDF5pp::createGroup: invalid max_compact/min_dense ('"+name+"')");
+            }
+
+            hid_t group = H5Gcreate2(m_file.getId(), name.c_str(), H5P_DEFAULT, plist,
+              H5P_DEFAULT);
+
+            H5Pclose(plist);
+
+            if ( group < 0 )
+              throw std::runtime_error("HDF5pp::createGroup: creating group failed ('"+name+"')");
+
+            H5Gclose(group);
+          }
+        }
+        m_groups.insert(name);
+      }
+    }
+    // - proceed to next "/"
+    idx = path.find("/",idx+1);
+  }
+}
+
+// ----------------------------------------- unlink a path -----------------------------------------
+
+inline void File::unlink(std::string path)
+{
+  // see all submitted asynchronous writes
+  waitAsync();
+
+  // discard pending entries of the path and of all datasets in it
+  for ( auto it = m_append.begin() ; it != m_append.end() ; )
+  {
+    if ( it->first == path || it->first.compare(0, path.size()+1, path+"/") == 0 )
+      it = m_append.erase(it);
+    else
+      ++it;
+  }
+
+  // close cached handles
+  uncache(path);
+
+  // forget the path, and all groups in it
+  for ( auto it = m_groups.begin() ; it != m_groups.end() ; )
+  {
+    if ( *it == path || it->compare(0, path.size()+1, path+"/") == 0 )
+      it = m_groups.erase(it);
+    else
+      ++it;
+  }
+
+  // unlink (the pending entries may not yet have created the dataset)
+  if ( m_file.exists(path.c_str()) ) m_file.unlink(path.c_str());
+}
+
+// ------------------ write pending entries of an extendable dataset to the file -------------------
+
+inline void File::writePending(const std::string &path)
+{
+  // find pending entries, remove them from the buffer
+  auto it = m_append.find(path);
+
+  if ( it == m_append.end() ) return;
+
+  AppendBuffer buf = std::move(it->second);
+
+  m_append.erase(it);
+
+  // nothing to write
+  if ( buf.n == 0 ) return;
+
+  // rank, required shape, and block of entries to write
+  // NB all axes but the first are those of the frame
+  int rank = 1 + static_cast<int>(buf.frame.size());
+
+  std::vector<hsize_t> end(rank), offset(rank, 0), count(rank);
+
+  end   [0] = static_cast<hsize_t>(buf.start + buf.n);
+  offset[0] = static_cast<hsize_t>(buf.start);
+  count [0] = static_cast<hsize_t>(buf.n);
+
+  for ( int i = 1 ; i < rank ; ++i )
+  {
+    end  [i] = static_cast<hsize_t>(buf.frame[i-1]);
+    count[i] = static_cast<hsize_t>(buf.frame[i-1]);
+  }
+
+  // open or create dataset
+  H5::DataSet dataset;
+
+  if ( !m_file.exists(path.c_str()) )
+  {
+    // set initial and maximum shape of the array (only the first axis can be extended)
+    // NB entries that have not been written are set to "fill_val"
+    std::vector<hsize_t> max_shape = end;
+
+    max_shape[0] = H5S_UNLIMITED;
+
+    // define the data-space
+    H5::DataSpace dataspace(rank, end.data(), max_shape.data());
+
+    // define data-type
+    H5::DataType datatype = buf.options.storageType(buf.type);
+
+    // enable chunking
+    H5::DSetCreatPropList chunk_param;
+    chunk_param.setChunk(rank, buf.chunk.data());
+
+    if ( buf.fill_val.size() ) chunk_param.setFillValue(buf.type, buf.fill_val.data());
+
+    // enable compression
+    buf.options.setFilters(chunk_param, datatype);
+
+    // create new dataset
+    dataset = createDataSet(path, datatype, dataspace, chunk_param);
+  }
+  else
+  {
+    // open dataset
+    dataset = openDataSet(path);
+
+    // read current shape (the rank has been checked when buffering the first entry)
+    std::vector<hsize_t> shape(rank);
+    dataset.getSpace().getSimpleExtentDims(shape.data(), NULL);
+
+    // extend shape, if needed
+    if ( shape[0] < end[0] )
+    {
+      shape[0] = end[0];
+      dataset.extend(shape.data());
+    }
+  }
+
+  // define the data-space of the block
+  H5::DataSpace mspace(rank, count.data());
+
+  // select a hyperslap
+  H5::DataSpace fspace = dataset.getSpace();
+  fspace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+
+  // write data to the hyperslap
+  dataset.write(buf.data.data(), buf.type, mspace, fspace);
+
+  // flush the file if so requested
+  autoflush(buf.data.size());
+}
+
+// ----------------- write pending entries of all extendable datasets to the file ------------------
+
+inline void File::writePending()
+{
+  // NB the path is copied, its entry is erased by "writePending(path)"
+  while ( !m_append.empty() ) writePending(std::string(m_append.begin()->first));
+}
+
+// ----------------------- open a dataset, after writing its pending entries -----------------------
+
+inline H5::DataSet File::openDataSet(const std::string &path)
+{
+  // write pending entries
+  writePending(path);
+
+  // return cached handle
+  auto it = m_cache.find(path);
+
+  if ( it != m_cache.end() && !it->second.is_group )
+  {
+    ++m_cache_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.dataset;
+  }
+
+  // open and cache dataset
+  ++m_cache_misses;
+
+  Handle handle{false, m_file.openDataSet(path.c_str()), H5::Group(), m_lru.end()};
+
+  cache(path, handle);
+
+  return handle.dataset;
+}
+
+// ----------------------------------------- open a group ------------------------------------------
+
+inline H5::Group File::openGroup(const std::string &path)
+{
+  // return cached handle
+  auto it = m_cache.find(path);
+
+  if ( it != m_cache.end() && it->second.is_group )
+  {
+    ++m_cache_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    return it->second.group;
+  }
+
+  // open and cache group
+  ++m_cache_misses;
+
+  Handle handle{true, H5::DataSet(), m_file.openGroup(path.c_str()), m_lru.end()};
+
+  cache(path, handle);
+
+  return handle.group;
+}
+
+// ----------------------------- create a dataset in its parent group ------------------------------
+
+inline H5::DataSet File::createDataSet(const std::string &path, const H5::DataType &datatype,
+  const H5::DataSpace &dataspace, const H5::DSetCreatPropList &plist)
+{
+  // split path in parent group and name
+  size_t idx = path.rfind("/");
+
+  // create dataset relative to its parent (if it is not the root)
+  H5::DataSet dataset;
+
+  if ( idx == std::string::npos || idx == 0 )
+    dataset = m_file.createDataSet(path.c_str(), datatype, dataspace, plist);
+  else
+    dataset = openGroup(path.substr(0,idx)).createDataSet(path.substr(idx+1).c_str(),
+      datatype, dataspace, plist);
+
+  // cache handle
+  cache(path, Handle{false, dataset, H5::Group(), m_lru.end()});
+
+  return dataset;
+}
+
+// ------------------------------------- store handle in cache -------------------------------------
+
+inline void File::cache(const std::string &path, const Handle &handle)
+{
+  // cache disabled
+  if ( m_cache_size == 0 ) return;
+
+  // remove old handle
+  auto it = m_cache.find(path);
+
+  if ( it != m_cache.end() )
+  {
+    m_lru.erase(it->second.lru);
+    m_cache.erase(it);
+  }
+
+  // close least recently used handle(s)
+  while ( m_cache.size() >= m_cache_size )
+  {
+    m_cache.erase(m_lru.back());
+    m_lru.pop_back();
+  }
+
+  // store handle
+  m_lru.push_front(path);
+
+  Handle &stored = m_cache.emplace(path, handle).first->second;
+
+  stored.lru = m_lru.begin();
+}
+
+// ------------------------------ remove handles of a path from cache ------------------------------
+
+inline void File::uncache(const std::string &path)
+{
+  for ( auto it = m_cache.begin() ; it != m_cache.end() ; )
+  {
+    if ( it->first == path || it->first.compare(0, path.size()+1, path+"/") == 0 )
+    {
+      m_lru.erase(it->second.lru);
+      it = m_cache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+// --------------------------------------- select hyperslab ----------------------------------------
+
+inline H5::DataSpace File::hyperslab(const H5::DataSet &dataset, const std::string &path,
+  const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &stride)
+{
+  // read data-space and shape
+  H5::DataSpace       dataspace = dataset.getSpace();
+  std::vector<size_t> shape     = this->shape(dataspace);
+
+  // rank
+  size_t rank = shape.size();
+
+  // check rank
+  if ( start.size() != rank || count.size() != rank || ( stride.size() != rank && stride.size() ) )
+    throw std::runtime_error("HDF5pp::hyperslab: rank inconsistent ('"+path+"')");
+
+  // convert to HDF5-type, check bounds
+  std::vector<hsize_t> offset(rank), block(rank), step(rank, 1);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+  {
+    offset[i] = static_cast<hsize_t>(start[i]);
+    block [i] = static_cast<hsize_t>(count[i]);
+
+    if ( stride.size() ) step[i] = static_cast<hsize_t>(stride[i]);
+
+    if ( count[i] > 0 && start[i] + (count[i]-1) * step[i] >= shape[i] )
+      throw std::runtime_error("HDF5pp::hyperslab: index out-of-bounds ('"+path+"')");
+  }
+
+  // select hyperslab (nothing if it is empty)
+  if ( std::find(count.begin(), count.end(), 0) != count.end() )
+    dataspace.selectNone();
+  else
+    dataspace.selectHyperslab(H5S_SELECT_SET, block.data(), offset.data(), step.data());
+
+  return dataspace;
+}
+
+// ---------------------------------- extend dataset to hyperslab ----------------------------------
+
+inline void File::extendDataSet(H5::DataSet &dataset, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride)
+{
+  // read data-space
+  H5::DataSpace dataspace = dataset.getSpace();
+  // read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // allocate shape and maximum shape as HDF5-type
+  std::vector<hsize_t> dims(rank), max_dims(rank);
+  // read shape and maximum shape
+  dataspace.getSimpleExtentDims(dims.data(), max_dims.data());
+  // check if the hyperslab exceeds the shape along extendable axes
+  bool extend = false;
+
+  if ( start.size() == dims.size() && count.size() == dims.size() )
+  {
+    for ( size_t i = 0 ; i < dims.size() ; ++i )
+    {
+      if ( count[i] == 0 ) continue;
+
+      hsize_t end = start[i] + (count[i]-1) * ( stride.size() ? stride[i] : 1 ) + 1;
+
+      if ( end > dims[i] && ( max_dims[i] == H5S_UNLIMITED || end <= max_dims[i] ) )
+      {
+        dims[i] = end;
+        extend  = true;
+      }
+    }
+  }
+
+  // collective (MPI): extend to the union of the hyperslabs of all processes
+  #ifdef HDF5PP_MPI
+    if ( m_mpi )
+    {
+      std::vector<hsize_t> current(rank);
+
+      dataspace.getSimpleExtentDims(current.data(), NULL);
+
+      std::vector<unsigned long long> end(dims.begin(), dims.end());
+
+      MPI_Allreduce(MPI_IN_PLACE, end.data(), rank, MPI_UNSIGNED_LONG_LONG, MPI_MAX, m_comm);
+
+      dims.assign(end.begin(), end.end());
+
+      extend = dims != current;
+    }
+  #endif
+
+  // extend
+  if ( extend ) dataset.extend(dims.data());
+}
+
+// ------------------------------------------ cache size -------------------------------------------
+
+inline void File::setCacheSize(size_t n)
+{
+  waitAsync();
+
+  m_cache_size = n;
+
+  while ( m_cache.size() > m_cache_size )
+  {
+    m_cache.erase(m_lru.back());
+    m_lru.pop_back();
+  }
+}
+
+// ---------------------------------------- clear the cache ----------------------------------------
+
+inline void File::clearCache()
+{
+  waitAsync();
+
+  m_cache.clear();
+  m_lru.clear();
+}
+
+// --------------------------------------- cache statistics ----------------------------------------
+
+inline size_t File::cacheHits() const
+{
+  waitAsync();
+
+  return m_cache_hits;
+}
+
+inline size_t File::cacheMisses() const
+{
+  waitAsync();
+
+  return m_cache_misses;
+}
+
+// ------------------------ read size of the data (total number of entries) ------------------------
+
+inline size_t File::size(std::string path)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::size: dataset not found ('"+path+"')");
+
+  // return size
+  return static_cast<size_t>(openDataSet(path).getSpace().getSelectNpoints());
+}
+
+// ------------------------------------ read shape of the data -------------------------------------
+
+inline std::vector<size_t> File::shape(std::string path)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::shape: dataset not found ('"+path+"')");
+
+  // open data-space
+  H5::DataSpace dataspace = openDataSet(path).getSpace();
+
+  // get the size in each direction
+  // - read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // - allocate as HDF5-type
+  std::vector<hsize_t> dimsf(rank);
+  // - allocate as vector
+  std::vector<size_t> shape(rank);
+  // - read
+  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
+  // - convert to vector
+  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+
+  return shape;
+}
+
+// ------------------------- read shape of the data along a specific axis --------------------------
+
+inline size_t File::shape(std::string path, size_t i)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::shape: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet   dataset   = openDataSet(path);
+  H5::DataSpace dataspace = dataset.getSpace();
+
+  // get the size in each direction
+  // - read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // - check rank
+  if ( rank < static_cast<int>(i) )
+    throw std::runtime_error("HDF5pp::shape: rank too low ('"+path+"')");
+  // - allocate as HDF5-type
+  std::vector<hsize_t> dimsf(rank);
+  // - read
+  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
+
+  return static_cast<size_t>(dimsf[i]);
+}
+
+// ------------------------ read the size of the data in an opened dataset -------------------------
+
+inline size_t File::size(const H5::DataSet &dataset)
+{
+  waitAsync();
+
+  return static_cast<size_t>(dataset.getSpace().getSelectNpoints());
+}
+
+// ----------------------- read the size of the data in an opened data-space -----------------------
+
+inline size_t File::size(const H5::DataSpace &dataspace)
+{
+  waitAsync();
+
+  return static_cast<size_t>(dataspace.getSelectNpoints());
+}
+
+// ------------------------ read the shape of the data in an opened dataset ------------------------
+
+inline std::vector<size_t> File::shape(const H5::DataSet &dataset)
+{
+  waitAsync();
+
+  // read the data-space
+  H5::DataSpace dataspace = dataset.getSpace();
+
+  // get the size in each direction
+  // - read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // - allocate as HDF5-type
+  std::vector<hsize_t> dimsf(rank);
+  // - allocate as vector
+  std::vector<size_t> shape(rank);
+  // - read
+  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
+  // - convert to vector
+  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+
+  return shape;
+}
+
+// ---------------------- read the shape of the data in an opened data-space -----------------------
+
+inline std::vector<size_t> File::shape(const H5::DataSpace &dataspace)
+{
+  waitAsync();
+
+  // get the size in each direction
+  // - read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // - allocate as HDF5-type
+  std::vector<hsize_t> dimsf(rank);
+  // - allocate as vector
+  std::vector<size_t> shape(rank);
+  // - read
+  dataspace.getSimpleExtentDims(dimsf.data(), NULL);
+  // - convert to vector
+  for ( int i = 0 ; i < rank ; ++i ) shape[i] = static_cast<size_t>(dimsf[i]);
+
+  return shape;
+}
+
+// ================================= READ/WRITE AN ENTIRE DATASET ==================================
+
+template<typename T>
+inline void File::readData(H5::DataSet &dataset, const std::string &path, T *output,
+  const H5::DataType& HT)
+{
+  #ifdef HDF5PP_ZLIB
+    ChunkPipeline pipe;
+
+    if ( chunkPipeline(dataset, HT, sizeof(T), true, pipe) )
+      return readChunks(dataset, path, reinterpret_cast<char*>(output), pipe);
+  #else
+    (void)path;
+  #endif
+
+  dataset.read(output, HT);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::writeData(H5::DataSet &dataset, const std::string &path, const T *input,
+  const H5::DataType& HT)
+{
+  #ifdef HDF5PP_ZLIB
+    ChunkPipeline pipe;
+
+    if ( chunkPipeline(dataset, HT, sizeof(T), false, pipe) )
+      return writeChunks(dataset, path, reinterpret_cast<const char*>(input), pipe);
+  #else
+    (void)path;
+  #endif
+
+  dataset.write(input, HT);
+}
+
+// --------------------------------------- number of threads ---------------------------------------
+
+inline void File::setThreads(size_t n)
+{
+  waitAsync();
+
+  m_threads = std::max(n, static_cast<size_t>(1));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+inline size_t File::threads() const
+{
+  waitAsync();
+
+  return m_threads;
+}
+
+// ============================= MULTI-THREADED CHUNK (DE)COMPRESSION ==============================
+
+#ifdef HDF5PP_ZLIB
+
+// ------------------------------- check if the pipeline can be used -------------------------------
+
+inline bool File::chunkPipeline(H5::DataSet &dataset, const H5::DataType& HT, size_t itemsize,
+  bool read, ChunkPipeline &pipe)
+{
+  // single thread: use HDF5
+  if ( m_threads <= 1 ) return false;
+
+  // parallel I/O: use HDF5
+  #ifdef HDF5PP_MPI
+    if ( m_mpi ) return false;
+  #endif
+
+  // chunked storage
+  H5::DSetCreatPropList plist = dataset.getCreatePlist();
+
+  if ( plist.getLayout() != H5D_CHUNKED ) return false;
+
+  // items are stored as in memory
+  H5::DataType datatype = dataset.getDataType();
+
+  if ( !( datatype == HT ) || datatype.getSize() != itemsize ) return false;
+
+  // only "deflate" and/or "shuffle"
+  int nfilter = plist.getNfilters();
+
+  if ( nfilter == 0 ) return false;
+
+  pipe.filters.clear();
+  pipe.level.clear();
+
+  for ( int i = 0 ; i < nfilter ; ++i )
+  {
+    unsigned int flags;
+    size_t       nvalues = 1;
+    unsigned int values[1] = {0};
+    char         name[16];
+    unsigned int config;
+
+    H5Z_filter_t filter = plist.getFilter(i, flags, nvalues, values, sizeof(name), name, config);
+
+    if ( filter != H5Z_FILTER_DEFLATE && filter != H5Z_FILTER_SHUFFLE ) return false;
+
+    pipe.filters.push_back(filter);
+    pipe.level  .push_back(static_cast<int>(values[0]));
+  }
+
+  // shape and chunk shape
+  H5::DataSpace dataspace = dataset.getSpace();
+
+  int rank = dataspace.getSimpleExtentNdims();
+
+  if ( rank < 1 ) return false;
+
+  pipe.shape.resize(rank);
+  pipe.chunk.resize(rank);
+  pipe.itemsize = itemsize;
+
+  dataspace.getSimpleExtentDims(pipe.shape.data(), NULL);
+
+  plist.getChunk(rank, pipe.chunk.data());
+
+  // number of chunks
+  hsize_t n = 1;
+
+  for ( int i = 0 ; i < rank ; ++i ) n *= (pipe.shape[i] + pipe.chunk[i] - 1) / pipe.chunk[i];
+
+  if ( n == 0 ) return false;
+
+  // read: all chunks have to be allocated (otherwise HDF5 supplies the fill value)
+  if ( read )
+  {
+    hsize_t nalloc;
+
+    if ( H5Dget_num_chunks(dataset.getId(), dataspace.getId(), &nalloc) < 0 || nalloc != n )
+      return false;
+  }
+
+  return true;
+}
+
+// ------------------------------------------ read chunks ------------------------------------------
+
+inline void File::readChunks(H5::DataSet &dataset, const std::string &path, char *output,
+  const ChunkPipeline &pipe)
+{
+  // raw chunk, as read from the file
+  struct Raw
+  {
+    std::vector<hsize_t> offset;
+    uint32_t             mask;
+    std::vector<char>    data;
+  };
+
+  // number of chunks along each axis, and in total
+  size_t rank = pipe.shape.size();
+  size_t n    = 1;
+
+  std::vector<hsize_t> nchunk(rank);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+  {
+    nchunk[i] = (pipe.shape[i] + pipe.chunk[i] - 1) / pipe.chunk[i];
+    n        *= nchunk[i];
+  }
+
+  // queue of raw chunks: filled by this thread, (de)compressed and copied by the workers
+  size_t                  nthread = std::min(m_threads, n);
+  std::deque<Raw>         queue;
+  std::mutex              mutex;
+  std::condition_variable changed;
+  bool                    done = false;
+  std::exception_ptr      error;
+
+  auto work = [&]()
+  {
+    while ( true )
+    {
+      Raw raw;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        changed.wait(lock, [&]{ return !queue.empty() || done || error; });
+
+        if ( queue.empty() || error ) return;
+
+        raw = std::move(queue.front());
+
+        queue.pop_front();
+      }
+
+      changed.notify_all();
+
+      try
+      {
+        std::vector<char> chunk = decodeChunk(std::move(raw.data), pipe, raw.mask);
+
+        copyChunk(output, chunk.data(), pipe, raw.offset, true);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ( !error ) error = std::current_exception();
+      }
+
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+
+  for ( size_t i = 0 ; i < nthread ; ++i ) workers.emplace_back(work);
+
+  // read raw chunks (HDF5 is only called from this thread)
+  for ( size_t k = 0 ; k < n ; ++k )
+  {
+    // - offset of the chunk
+    Raw raw{std::vector<hsize_t>(rank), 0, std::vector<char>()};
+
+    for ( size_t i = rank, j = k ; i-- > 0 ; j /= nchunk[i] )
+      raw.offset[i] = (j % nchunk[i]) * pipe.chunk[i];
+
+    // - read
+    hsize_t nbytes;
+
+    bool ok = H5Dget_chunk_storage_size(dataset.getId(), raw.offset.data(), &nbytes) >= 0;
+
+    if ( ok )
+    {
+      raw.data.resize(nbytes);
+
+      ok = H5Dread_chunk(dataset.getId(), H5P_DEFAULT, raw.offset.data(), &raw.mask,
+        raw.data.data()) >= 0;
+    }
+
+    // - add to the queue (of at most two chunks per worker)
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if ( !ok && !error )
+      error = std::make_exception_ptr(std::runtime_error(
+        "HDF5pp::read: reading chunk failed ('"+path+"')"));
+
+    changed.wait(lock, [&]{ return queue.size() < 2*nthread || error; });
+
+    if ( error ) break;
+
+    queue.push_back(std::move(raw));
+
+    lock.unlock();
+
+    changed.notify_all();
+  }
+
+  // finish
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+
+  changed.notify_all();
+
+  for ( auto &worker : workers ) worker.join();
+
+  if ( error ) std::rethrow_exception(error);
+}
+
+// ----------------------------------------- write chunks ------------------------------------------
+
+inline void File::writeChunks(H5::DataSet &dataset, const std::string &path, const char *input,
+  const ChunkPipeline &pipe)
+{
+  // compressed chunk, to be written to the file
+  struct Raw
+  {
+    std::vector<hsize_t> offset;
+    std::vector<char>    data;
+  };
+
+  // number of chunks along each axis, and in total; number of bytes per chunk
+  size_t rank   = pipe.shape.size();
+  size_t n      = 1;
+  size_t nbytes = pipe.itemsize;
+
+  std::vector<hsize_t> nchunk(rank);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+  {
+    nchunk[i] = (pipe.shape[i] + pipe.chunk[i] - 1) / pipe.chunk[i];
+    n        *= nchunk[i];
+    nbytes   *= pipe.chunk[i];
+  }
+
+  // queue of compressed chunks: filled by the workers, written by this thread
+  size_t                  nthread = std::min(m_threads, n);
+  std::atomic<size_t>     next(0);
+  size_t                  finished = 0;
+  std::deque<Raw>         queue;
+  std::mutex              mutex;
+  std::condition_variable changed;
+  std::exception_ptr      error;
+
+  auto work = [&]()
+  {
+    for ( size_t k = next++ ; k < n ; k = next++ )
+    {
+      try
+      {
+        // - offset of the chunk
+        Raw raw{std::vector<hsize_t>(rank), std::vector<char>(nbytes, 0)};
+
+        for ( size_t i = rank, j = k ; i-- > 0 ; j /= nchunk[i] )
+          raw.offset[i] = (j % nchunk[i]) * pipe.chunk[i];
+
+        // - copy from the input (the part outside the dataset remains zero), compress
+        copyChunk(const_cast<char*>(input), raw.data.data(), pipe, raw.offset, false);
+
+        raw.data = encodeChunk(std::move(raw.data), pipe);
+
+        // - add to the queue (of at most two chunks per worker)
+        std::unique_lock<std::mutex> lock(mutex);
+
+        changed.wait(lock, [&]{ return queue.size() < 2*nthread || error; });
+
+        if ( error ) break;
+
+        queue.push_back(std::move(raw));
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if ( !error ) error = std::current_exception();
+      }
+
+      changed.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++finished;
+    }
+
+    changed.notify_all();
+  };
+
+  std::vector<std::thread> workers;
+
+  for ( size_t i = 0 ; i < nthread ; ++i ) workers.emplace_back(work);
+
+  // write compressed chunks (HDF5 is only called from this thread)
+  while ( true )
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    changed.wait(lock, [&]{ return !queue.empty() || finished == nthread || error; });
+
+    if ( error || queue.empty() ) break;
+
+    Raw raw = std::move(queue.front());
+
+    queue.pop_front();
+
+    lock.unlock();
+
+    changed.notify_all();
+
+    if ( H5Dwrite_chunk(dataset.getId(), H5P_DEFAULT, 0, raw.offset.data(), raw.data.size(),
+      raw.data.data()) < 0 )
+    {
+      std::lock_guard<std::mutex> relock(mutex);
+      if ( !error ) error = std::make_exception_ptr(std::runtime_error(
+        "HDF5pp::write: writing chunk failed ('"+path+"')"));
+    }
+  }
+
+  changed.notify_all();
+
+  for ( auto &worker : workers ) worker.join();
+
+  if ( error ) std::rethrow_exception(error);
+}
+
+#endif
+
+// ======================================== MAPPED DATASET =========================================
+
+template<typename T>
+inline const T* Mapped<T>::data() const
+{
+  return m_data;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline const T* Mapped<T>::begin() const
+{
+  return m_data;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline const T* Mapped<T>::end() const
+{
+  return m_data + m_size;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline const T& Mapped<T>::operator[](size_t i) const
+{
+  return m_data[i];
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline std::vector<size_t> Mapped<T>::shape() const
+{
+  return m_shape;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline size_t Mapped<T>::size() const
+{
+  return m_size;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline bool Mapped<T>::mapped() const
+{
+  return m_mapped;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#ifdef HDF5PP_XTENSOR
+
+template<typename T>
+inline auto Mapped<T>::xview() const
+{
+  return xt::adapt(m_data, m_size, xt::no_ownership(), m_shape);
+}
+
+#endif
+
+// ------------------------------------------ map dataset ------------------------------------------
+
+template<typename T>
+inline Mapped<T> File::map(std::string path)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::map: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::map: precision inconsistent ('"+path+"')");
+  #endif
+
+  // shape
+  Mapped<T> out;
+
+  out.m_shape = this->shape(dataset);
+  out.m_size  = this->size(dataset);
+
+  // map the file
+  const void* data = mapDataSet(dataset, getType<T>(), out.m_size*sizeof(T), alignof(T),
+    out.m_region);
+
+  if ( data )
+  {
+    out.m_data   = static_cast<const T*>(data);
+    out.m_mapped = true;
+
+    return out;
+  }
+
+  // read the data
+  auto buffer = std::make_shared<std::vector<T>>(out.m_size);
+
+  readData(dataset, path, buffer->data(), getType<T>());
+
+  out.m_data   = buffer->data();
+  out.m_region = buffer;
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+inline const void* File::mapDataSet(H5::DataSet &dataset, const H5::DataType& HT, size_t nbytes,
+  size_t align, std::shared_ptr<const void> &region)
+{
+  #ifndef HDF5PP_MMAP
+    return nullptr;
+  #else
+
+  // parallel I/O: read
+  #ifdef HDF5PP_MPI
+    if ( m_mpi ) return nullptr;
+  #endif
+
+  // nothing to map
+  if ( nbytes == 0 ) return nullptr;
+
+  // the file is accessed directly (default driver), the dataset is stored contiguously as in memory
+  if ( m_file.getAccessPlist().getDriver() != H5FD_SEC2 ) return nullptr;
+
+  if ( dataset.getCreatePlist().getLayout() != H5D_CONTIGUOUS ) return nullptr;
+
+  if ( !( dataset.getDataType() == HT ) ) return nullptr;
+
+  // offset of the data in the file (undefined if the data has not been allocated)
+  haddr_t offset = H5Dget_offset(dataset.getId());
+
+  if ( offset == HADDR_UNDEF ) return nullptr;
+
+  // write the data to the file
+  // NB a local flush, that is not counted in "flushStats"
+  m_file.flush(H5F_SCOPE_LOCAL);
+
+  // map the pages that contain the data
+  size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t start = static_cast<size_t>(offset) - static_cast<size_t>(offset) % page;
+  size_t len   = static_cast<size_t>(offset) - start + nbytes;
+
+  int fd = ::open(m_fname.c_str(), O_RDONLY);
+
+  if ( fd < 0 ) return nullptr;
+
+  void* addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(start));
+
+  ::close(fd);
+
+  if ( addr == MAP_FAILED ) return nullptr;
+
+  // unmap when the last copy of the region is destroyed
+  region = std::shared_ptr<const void>(addr, [len](const void* p)
+  {
+    munmap(const_cast<void*>(p), len);
+  });
+
+  // pointer to the data (that has to be aligned)
+  const char* data = static_cast<const char*>(addr) + (static_cast<size_t>(offset) - start);
+
+  if ( reinterpret_cast<uintptr_t>(data) % align != 0 )
+  {
+    region.reset();
+    return nullptr;
+  }
+
+  return data;
+
+  #endif
+}
+
+// =================================== BATCH OF WRITE OPERATIONS ===================================
+
+inline Batch File::batch()
+{
+  waitAsync();
+
+  return Batch(*this);
+}
+
+// ------------------------------------------ constructor ------------------------------------------
+
+inline Batch::Batch(File &file) : m_file(&file)
+{
+}
+
+// --------------------------------------- record operations ---------------------------------------
+
+template<class... Args>
+inline Batch& Batch::write(std::string path, Args&&... args)
+{
+  File* file = m_file;
+
+  m_paths.push_back(path);
+
+  m_ops.push_back([file, path, data = std::make_tuple(std::forward<Args>(args)...)]() mutable
+  {
+    auto fn = [file, &path](auto&... a){ file->write(path, a...); };
+
+    applyTuple(fn, data, std::index_sequence_for<Args...>());
+  });
+
+  return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<class... Args>
+inline Batch& Batch::overwrite(std::string path, Args&&... args)
+{
+  File* file = m_file;
+
+  m_paths.push_back(path);
+
+  m_ops.push_back([file, path, data = std::make_tuple(std::forward<Args>(args)...)]() mutable
+  {
+    auto fn = [file, &path](auto&... a){ file->overwrite(path, a...); };
+
+    applyTuple(fn, data, std::index_sequence_for<Args...>());
+  });
+
+  return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<class... Args>
+inline Batch& Batch::append(std::string path, Args&&... args)
+{
+  File* file = m_file;
+
+  m_paths.push_back(path);
+
+  m_ops.push_back([file, path, data = std::make_tuple(std::forward<Args>(args)...)]() mutable
+  {
+    auto fn = [file, &path](auto&... a){ file->append(path, a...); };
+
+    applyTuple(fn, data, std::index_sequence_for<Args...>());
+  });
+
+  return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+inline size_t Batch::size() const
+{
+  return m_ops.size();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+inline void Batch::clear()
+{
+  m_paths.clear();
+  m_ops.clear();
+}
+
+// -------------------------------------------- commit ---------------------------------------------
+
+inline BatchStats Batch::commit()
+{
+  using clock = std::chrono::steady_clock;
+
+  BatchStats stats;
+
+  File &file = *m_file;
+
+  // counters before the batch
+  FlushStats before = file.flushStats();
+
+  auto t0 = clock::now();
+
+  // perform the operations without flushing
+  file.m_batch = true;
+
+  try
+  {
+    // - create the groups of all paths, once per parent group
+    std::vector<std::string> paths = m_paths;
+
+    std::sort(paths.begin(), paths.end());
+
+    std::string parent;
+
+    for ( auto &path : paths )
+    {
+      std::string group = path.substr(0, path.rfind("/"));
+
+      if ( group == parent ) continue;
+
+      file.createGroup(path);
+
+      parent = group;
+    }
+
+    auto t1 = clock::now();
+
+    // - write
+    for ( auto &op : m_ops ) op();
+
+    auto t2 = clock::now();
+
+    stats.groups = std::chrono::duration<double>(t1-t0).count();
+    stats.write  = std::chrono::duration<double>(t2-t1).count();
+  }
+  catch (...)
+  {
+    file.m_batch = false;
+    clear();
+    throw;
+  }
+
+  file.m_batch = false;
+
+  clear();
+
+  // flush once, if the policy requires it
+  auto t3 = clock::now();
+
+  if ( file.flushDue() ) file.flushFile();
+
+  auto t4 = clock::now();
+
+  // timing
+  FlushStats after = file.flushStats();
+
+  stats.writes = after.writes - before.writes;
+  stats.bytes  = after.bytes  - before.bytes;
+  stats.flush  = std::chrono::duration<double>(t4-t3).count();
+  stats.total  = std::chrono::duration<double>(t4-t0).count();
+
+  return stats;
+}
+
+// ====================================== BLOCKS OF A DATASET ======================================
+
+template<typename T>
+inline Blocks<T> File::iterate(std::string path, size_t block)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::iterate: dataset not found ('"+path+"')");
+
+  if ( block == 0 )
+    throw std::runtime_error("HDF5pp::iterate: block of zero rows ('"+path+"')");
+
+  // open dataset (after writing its pending entries)
+  Blocks<T> out;
+
+  out.m_path    = path;
+  out.m_dataset = openDataSet(path);
+  out.m_type    = getType<T>();
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(out.m_dataset) )
+      throw std::runtime_error("HDF5pp::iterate: precision inconsistent ('"+path+"')");
+  #endif
+
+  // read shape
+  std::vector<size_t> shape = this->shape(out.m_dataset);
+
+  if ( shape.size() == 0 )
+    throw std::runtime_error("HDF5pp::iterate: dataset is a scalar ('"+path+"')");
+
+  out.m_rows    = shape[0];
+  out.m_block   = block;
+  out.m_nblocks = ( shape[0] + block - 1 ) / block;
+  out.m_frame   = 1;
+
+  for ( size_t i = 1 ; i < shape.size() ; ++i ) out.m_frame *= shape[i];
+
+  // allocate the buffers, and the hyperslabs
+  size_t n = std::min(block, shape[0]);
+
+  for ( size_t i = 0 ; i < 2 ; ++i )
+  {
+    out.m_buffer[i].resize(n * out.m_frame);
+    out.m_offset[i].assign(shape.size(), 0);
+    out.m_count [i].assign(shape.begin(), shape.end());
+  }
+
+  out.m_current.shape = shape;
+
+  // start reading the first block
+  out.m_worker = reader();
+
+  if ( out.m_nblocks > 0 ) out.prefetch(0);
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline size_t Block<T>::size() const
+{
+  size_t n = 1;
+
+  for ( auto &i : shape ) n *= i;
+
+  return n;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline Blocks<T>::~Blocks()
+{
+  if ( m_pending.valid() ) m_pending.wait();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void Blocks<T>::prefetch(size_t index)
+{
+  // hyperslab of the block
+  size_t slot = index % 2;
+
+  m_offset[slot][0] = static_cast<hsize_t>(index * m_block);
+  m_count [slot][0] = static_cast<hsize_t>(std::min(m_block, m_rows - index * m_block));
+
+  // read in the background
+  // NB only identifiers and pointers (to buffers that are not reallocated) are passed, such that
+  //    nothing of the HDF5 library is used (or released) by this thread after the read
+  hid_t          dset   = m_dataset.getId();
+  hid_t          type   = m_type.getId();
+  hsize_t        n      = m_count[slot][0] * static_cast<hsize_t>(m_frame);
+  const hsize_t* offset = m_offset[slot].data();
+  const hsize_t* count  = m_count [slot].data();
+  T*             output = m_buffer[slot].data();
+
+  m_next    = index;
+  m_pending = m_worker->push([dset, type, n, offset, count, output]()
+  {
+    hid_t fspace = H5Dget_space(dset);
+    hid_t mspace = H5Screate_simple(1, &n, NULL);
+
+    herr_t status = H5Sselect_hyperslab(fspace, H5S_SELECT_SET, offset, NULL, count, NULL);
+
+    if ( status >= 0 ) status = H5Dread(dset, type, mspace, fspace, H5P_DEFAULT, output);
+
+    H5Sclose(mspace);
+    H5Sclose(fspace);
+
+    if ( status < 0 ) throw std::runtime_error("HDF5pp::iterate: reading a block failed");
+  });
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void Blocks<T>::fetch(size_t index)
+{
+  // wait for the block (rethrows the exception of the read, if any)
+  if ( !m_pending.valid() || m_next != index )
+    throw std::runtime_error("HDF5pp::iterate: blocks can only be iterated once ('"+m_path+"')");
+
+  m_pending.get();
+
+  // set the current block
+  size_t slot = index % 2;
+
+  m_current.data     = m_buffer[slot].data();
+  m_current.start    = static_cast<size_t>(m_offset[slot][0]);
+  m_current.rows     = static_cast<size_t>(m_count [slot][0]);
+  m_current.shape[0] = m_current.rows;
+
+  // start reading the next block
+  if ( index + 1 < m_nblocks ) prefetch(index + 1);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline typename Blocks<T>::iterator Blocks<T>::begin()
+{
+  if ( m_nblocks > 0 ) fetch(0);
+
+  return iterator(this, 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline typename Blocks<T>::iterator Blocks<T>::end()
+{
+  return iterator(this, m_nblocks);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline size_t Blocks<T>::size() const
+{
+  return m_nblocks;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline size_t Blocks<T>::block() const
+{
+  return m_block;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline Blocks<T>::iterator::iterator(Blocks *blocks, size_t index) :
+  m_blocks(blocks), m_index(index)
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline const Block<T>& Blocks<T>::iterator::operator*() const
+{
+  return m_blocks->m_current;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline const Block<T>* Blocks<T>::iterator::operator->() const
+{
+  return &m_blocks->m_current;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline typename Blocks<T>::iterator& Blocks<T>::iterator::operator++()
+{
+  ++m_index;
+
+  if ( m_index < m_blocks->m_nblocks ) m_blocks->fetch(m_index);
+
+  return *this;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline bool Blocks<T>::iterator::operator==(const iterator &other) const
+{
+  return m_blocks == other.m_blocks && m_index == other.m_index;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline bool Blocks<T>::iterator::operator!=(const iterator &other) const
+{
+  return !(*this == other);
+}
+
+// ======================================== DATASET HANDLE =========================================
+
+template<typename T, size_t Rank>
+inline Dataset<T,Rank> File::dataset(const std::string &path)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::dataset: dataset not found ('"+path+"')");
+
+  // open dataset (after writing its pending entries)
+  Dataset<T,Rank> out;
+
+  out.m_file    = this;
+  out.m_path    = path;
+  out.m_dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(out.m_dataset) )
+      throw std::runtime_error("HDF5pp::dataset: precision inconsistent ('"+path+"')");
+  #endif
+
+  // store data-space and data-type
+  out.m_space = out.m_dataset.getSpace();
+  out.m_type  = getType<T>();
+
+  // check rank
+  if ( Rank != dynamic_rank && static_cast<size_t>(out.m_space.getSimpleExtentNdims()) != Rank )
+    throw std::runtime_error("HDF5pp::dataset: rank inconsistent ('"+path+"')");
+
+  // store shape
+  out.setShape();
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline Dataset<T,Rank> File::dataset(const std::string &path, const std::vector<size_t> &shape)
+{
+  return dataset<T,Rank>(path, shape, m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline Dataset<T,Rank> File::dataset(const std::string &path, const std::vector<size_t> &shape,
+  const DataSetOptions &options)
+{
+  // create dataset, if needed
+  if ( ! exists(path) )
+  {
+    createGroup(path);
+    createArray(path, getType<T>(), shape, options, sizeof(T));
+  }
+
+  // open dataset
+  Dataset<T,Rank> out = dataset<T,Rank>(path);
+
+  // check shape (along the axes that cannot be extended)
+  std::vector<hsize_t> dims(shape.size()), max_dims(shape.size());
+
+  if ( static_cast<size_t>(out.m_space.getSimpleExtentNdims()) != shape.size() )
+    throw std::runtime_error("HDF5pp::dataset: rank inconsistent ('"+path+"')");
+
+  out.m_space.getSimpleExtentDims(dims.data(), max_dims.data());
+
+  for ( size_t i = 0 ; i < shape.size() ; ++i )
+    if ( dims[i] != shape[i] && dims[i] == max_dims[i] )
+      throw std::runtime_error("HDF5pp::dataset: shape inconsistent ('"+path+"')");
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline std::string Dataset<T,Rank>::path() const
+{
+  return m_path;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline size_t Dataset<T,Rank>::rank() const
+{
+  return static_cast<size_t>(m_space.getSimpleExtentNdims());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline typename Dataset<T,Rank>::shape_type Dataset<T,Rank>::shape() const
+{
+  return m_shape;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline size_t Dataset<T,Rank>::shape(size_t i) const
+{
+  return m_shape[i];
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline size_t Dataset<T,Rank>::size() const
+{
+  return m_size;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::setShape()
+{
+  std::vector<hsize_t> dims(m_space.getSimpleExtentNdims());
+
+  m_space.getSimpleExtentDims(dims.data(), NULL);
+
+  m_shape = shape_type();
+  m_size  = 1;
+
+  resize(m_shape, dims.size());
+
+  for ( size_t i = 0 ; i < dims.size() ; ++i )
+  {
+    m_shape[i] = static_cast<size_t>(dims[i]);
+    m_size    *= m_shape[i];
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline hsize_t Dataset<T,Rank>::select(const shape_type &start, const shape_type &count,
+  const shape_type &stride)
+{
+  assert( start.size() == m_shape.size() && count.size() == m_shape.size() );
+  assert( stride.size() == m_shape.size() || stride.empty() );
+
+  // convert to HDF5-type
+  size_t  rank = m_shape.size();
+  hsize_t n    = 1;
+
+  std::vector<hsize_t> offset(rank), block(rank), step(rank, 1);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+  {
+    offset[i] = static_cast<hsize_t>(start[i]);
+    block [i] = static_cast<hsize_t>(count[i]);
+    n        *= block[i];
+
+    if ( stride.size() && stride[i] > 0 ) step[i] = static_cast<hsize_t>(stride[i]);
+  }
+
+  // select hyperslab (nothing if it is empty)
+  if ( n == 0 ) m_space.selectNone();
+  else          m_space.selectHyperslab(H5S_SELECT_SET, block.data(), offset.data(), step.data());
+
+  return n;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::write(const T *input)
+{
+  // finish asynchronous writes
+  m_file->waitAsync();
+
+  // write, using several threads to compress chunks if so requested
+  #ifdef HDF5PP_ZLIB
+    if ( m_file->m_threads > 1 )
+      m_file->writeData(m_dataset, m_path, input, m_type);
+    else
+      m_dataset.write(input, m_type, H5S_ALL, H5S_ALL, m_file->m_xfer);
+  #else
+    m_dataset.write(input, m_type, H5S_ALL, H5S_ALL, m_file->m_xfer);
+  #endif
+
+  // flush the file if so requested
+  m_file->autoflush(m_size*sizeof(T));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::write(const std::vector<T> &input)
+{
+  assert( input.size() == m_size );
+
+  write(input.data());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::read(T *output)
+{
+  // finish asynchronous writes
+  m_file->waitAsync();
+
+  // read, using several threads to decompress chunks if so requested
+  #ifdef HDF5PP_ZLIB
+    if ( m_file->m_threads > 1 )
+      return m_file->readData(m_dataset, m_path, output, m_type);
+  #endif
+
+  m_dataset.read(output, m_type);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline std::vector<T> Dataset<T,Rank>::read()
+{
+  std::vector<T> out(m_size);
+
+  read(out.data());
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::append(const T *input)
+{
+  assert( m_shape.size() > 0 );
+
+  // finish asynchronous writes
+  m_file->waitAsync();
+
+  // read the current shape (the dataset may have been extended by a copy of this handle)
+  m_space = m_dataset.getSpace();
+
+  setShape();
+
+  // extend the first axis by one frame
+  size_t rank = m_shape.size();
+
+  std::vector<hsize_t> dims(rank), offset(rank, 0), count(rank);
+
+  for ( size_t i = 0 ; i < rank ; ++i )
+  {
+    dims [i] = static_cast<hsize_t>(m_shape[i]);
+    count[i] = static_cast<hsize_t>(m_shape[i]);
+  }
+
+  offset[0] = dims[0];
+  count [0] = 1;
+  dims  [0] += 1;
+
+  m_dataset.extend(dims.data());
+
+  m_space = m_dataset.getSpace();
+
+  // write the frame
+  hsize_t n = 1;
+
+  for ( auto &i : count ) n *= i;
+
+  H5::DataSpace mspace(1, &n);
+
+  m_space.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+
+  m_dataset.write(input, m_type, mspace, m_space, m_file->m_xfer);
+
+  // update the shape
+  m_shape[0] += 1;
+  m_size     += n;
+
+  // flush the file if so requested
+  m_file->autoflush(n*sizeof(T));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::append(const std::vector<T> &input)
+{
+  assert( m_shape.size() > 0 );
+  assert( m_shape[0] == 0 || input.size() * m_shape[0] == m_size );
+
+  append(input.data());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::read_slice(T *output, const shape_type &start,
+  const shape_type &count, const shape_type &stride)
+{
+  // finish asynchronous writes
+  m_file->waitAsync();
+
+  // select hyperslab, define the data-space of the output
+  hsize_t n = select(start, count, stride);
+
+  H5::DataSpace mspace(1, &n);
+
+  // read
+  m_dataset.read(output, m_type, mspace, m_space);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline std::vector<T> Dataset<T,Rank>::read_slice(const shape_type &start,
+  const shape_type &count, const shape_type &stride)
+{
+  size_t n = 1;
+
+  for ( auto &i : count ) n *= i;
+
+  std::vector<T> out(n);
+
+  read_slice(out.data(), start, count, stride);
+
+  return out;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::write_slice(const T *input, const shape_type &start,
+  const shape_type &count, const shape_type &stride)
+{
+  // finish asynchronous writes
+  m_file->waitAsync();
+
+  // select hyperslab, define the data-space of the input
+  hsize_t n = select(start, count, stride);
+
+  H5::DataSpace mspace(1, &n);
+
+  // write
+  m_dataset.write(input, m_type, mspace, m_space, m_file->m_xfer);
+
+  // flush the file if so requested
+  m_file->autoflush(n*sizeof(T));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T, size_t Rank>
+inline void Dataset<T,Rank>::write_slice(const std::vector<T> &input,
+  const shape_type &start, const shape_type &count, const shape_type &stride)
+{
+  #ifndef NDEBUG
+    size_t n = 1;
+    for ( auto &i : count ) n *= i;
+    assert( input.size() == n );
+  #endif
+
+  write_slice(input.data(), start, count, stride);
+}
+
+// ============================= WRITE STD::STRING TO SEPARATE DATASET =============================
+
+inline void File::write(std::string path, std::string input)
+{
+  // check existence of path
+  if ( exists(path) )
+    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
+
+  // create group(s) if needed
+  createGroup(path);
+
+  // set data-type and data-space
+  H5::StrType   datatype(0, H5T_VARIABLE);
+  H5::DataSpace dataspace(H5S_SCALAR);
+
+  // create dataset
+  H5::DataSet dataset = createDataSet(path, datatype, dataspace);
+
+  // write string to dataset
+  dataset.write(input, datatype, dataspace);
+
+  // flush the file if so requested
+  autoflush(input.size());
+}
+
+// ================================= READ AS A SPECIFIC DATA-TYPE ==================================
+
+template<typename T>
+inline T File::read(std::string path)
+{
+  return read_impl(path, Tag<T>());
+}
+
+// =================== READ STD::STRING FROM DATASET THAT ONLY CONTAINS A STRING ===================
+
+template<>
+inline std::string File::read<std::string>(std::string path)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset, get data-type
+  H5::DataSet dataset = openDataSet(path);
+
+  // allocate output
+  std::string out;
+
+  // read output
+  dataset.read(out, dataset.getStrType(), dataset.getSpace());
+
+  return out;
+}
+
+// ================= CHECK IF DATASET HAS A PRECISION THAT MATCHES A SPECIFIC TYPE =================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline bool File::correct_presision(const H5::DataSet &dataset)
+{
+  // data-type of "T"
+  H5::DataType type = getType<T>();
+
+  // check data-type
+  if ( dataset.getTypeClass() != type.getClass() ) return false;
+
+  // check the number of bytes (a narrower data-type in the file is converted when reading)
+  if ( dataset.getDataType().getSize() > type.getSize() ) return false;
+
+  return true;
+}
+
+// ================================ WRITE SCALAR TO SCALAR DATASET =================================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T, typename>
+inline void File::write(std::string path, T input, const H5::DataType& HT)
+{
+  // check existence of path
+  if ( exists(path) )
+    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
+
+  // create group(s) if needed
+  createGroup(path);
+
+  // define data-type (see "DataSetOptions::storage"), force little-endian storage
+  H5::DataType datatype = m_options.storageType(HT);
+
+  // add dataset to file (compact, unless disabled or in a parallel file)
+  DataSetOptions options = m_options;
+  #ifdef HDF5PP_MPI
+  if ( m_mpi ) options.compact = 0;
+  #endif
+
+  H5::DataSet dataset = createDataSet(path, datatype, H5::DataSpace(H5S_SCALAR),
+    options.plist({}, sizeof(T)));
+
+  // store data
+  dataset.write(&input, HT);
+
+  // flush the file if so requested
+  autoflush(sizeof(T));
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T, typename>
+inline void File::write(std::string path, T input)
+{
+  return write<T>(path,input,getType<T>());
+}
+
+// ============================== OVERWRITE SCALAR TO SCALAR DATASET ===============================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T, typename>
+inline void File::overwrite(std::string path, T input, const H5::DataType& HT)
+{
+  // new dataset: write using normal function
+  if ( ! exists(path) ) return write<T>(path,input,HT);
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::overwrite: precision inconsistent ('"+path+"')");
+  #endif
+
+  // check size
+  if ( size(dataset) != 1 )
+    throw std::runtime_error("HDF5pp::overwrite: dataset has a rank different than 1 ('"+path+"')");
+
+  // store data
+  dataset.write(&input, HT);
+
+  // flush the file if so requested
+  autoflush(sizeof(T));
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T, typename>
+inline void File::overwrite(std::string path, T input)
+{
+  return overwrite<T>(path,input,getType<T>());
+}
+
+// ======================== READ SCALAR FROM DATASET (SCALAR, OR OF SIZE 1) ========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline T File::read_scalar(std::string path, const H5::DataType& HT)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
+  #endif
+
+  // check size
+  if ( this->size(dataset) > 1 )
+    throw std::runtime_error("HDF5pp::read: dataset has a rank different than 1 ('"+path+"')");
+
+  // allocate output
+  T out;
+
+  // read output
+  dataset.read(&out, HT);
+
+  return out;
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline T File::read_impl(std::string path, Tag<T>)
+{
+  return read_scalar<T>(path,getType<T>());
+}
+
+// ========================= WRITE SCALAR TO EXTENDABLE DATASET OF RANK 1 ==========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path, T input, const H5::DataType& HT,
+  size_t index, T fill_val, size_t chunk_size
+)
+{
+  // see all submitted asynchronous writes
+  waitAsync();
+
+  // buffer entry
+  // ------------
+
+  // continue the pending entries, if the entry is consecutive (or replaces a pending entry)
+  auto it = m_append.find(path);
+
+  if ( it != m_append.end() )
+  {
+    AppendBuffer &buf = it->second;
+
+    if ( buf.type == HT && buf.frame.empty() &&
+         index >= buf.start && index <= buf.start+buf.n )
+    {
+      // - add entry if needed
+      if ( index == buf.start+buf.n )
+      {
+        ++buf.n;
+        buf.data.resize(buf.n*sizeof(T));
+      }
+
+      // - store entry
+      std::memcpy(&buf.data[(index-buf.start)*sizeof(T)], &input, sizeof(T));
+
+      // - write a full chunk
+      if ( (buf.start+buf.n) % buf.chunk_size == 0 ) writePending(path);
+
+      return;
+    }
+
+    // - write the pending entries before starting a new block
+    writePending(path);
+  }
+
+  // start new block
+  // ---------------
+
+  if ( !exists(path) )
+  {
+    // create group(s) if needed
+    createGroup(path);
+  }
+  else
+  {
+    // open dataset
+    H5::DataSet   dataset   = openDataSet(path);
+    H5::DataSpace dataspace = dataset.getSpace();
+
+    // check precision
+    #ifndef HDF5PP_NDEBUG_PRECISION
+      if ( ! this->correct_presision<T>(dataset) )
+        throw std::runtime_error("HDF5pp::write: precision inconsistent ('"+path+"')");
+    #endif
+
+    // check rank (here only simple arrays are supported)
+    if ( dataspace.getSimpleExtentNdims() != 1 )
+      throw std::runtime_error("HDF5pp::write: can only extend rank 1 array ('"+path+"')");
+  }
+
+  // allocate block, store the first entry
+  AppendBuffer buf{HT, {}, index, 1, chunk_size, {static_cast<hsize_t>(chunk_size)}, m_options,
+    std::vector<char>(sizeof(T)), std::vector<char>(sizeof(T))};
+
+  std::memcpy(buf.fill_val.data(), &fill_val, sizeof(T));
+  std::memcpy(buf.data.data(), &input, sizeof(T));
+
+  m_append.emplace(path, std::move(buf));
+
+  // write a full chunk
+  if ( chunk_size == 0 || (index+1) % chunk_size == 0 ) writePending(path);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T, typename>
+inline void File::write(
+  std::string path, T input, size_t index, T fill_val, size_t chunk_size
+)
+{
+  return write<T>(path,input,getType<T>(),index,fill_val,chunk_size);
+}
+
+// ============================== READ SCALAR FROM DATASET OF RANK 1 ===============================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline T File::read(std::string path, const H5::DataType& HT, size_t index)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet   dataset   = openDataSet(path);
+  H5::DataSpace dataspace = dataset.getSpace();
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read: incorrect precision ('"+path+"')");
+  #endif
+
+  // get the current rank and shape
+  // - read rank (a.k.a number of dimensions)
+  int rank = dataspace.getSimpleExtentNdims();
+  // - allocate shape as HDF5-type
+  std::vector<hsize_t> shape(rank);
+  // - read shape
+  dataspace.getSimpleExtentDims(shape.data(), NULL);
+
+  // check rank (here only simple arrays are supported)
+  if ( rank != 1 )
+    throw std::runtime_error("HDF5pp::read: dataset not rank 1 ('"+path+"')");
+
+  // check the shape
+  if ( index >= shape[0] )
+    throw std::runtime_error("HDF5pp::read: index out-of-bounds ('"+path+"')");
+
+  // set offset
+  std::vector<hsize_t> offset(rank, index);
+
+  // pseudo-shape of the array
+  std::vector<hsize_t> extra_shape(rank, 1);
+
+  // define the extra data-space
+  H5::DataSpace extra_datasape(rank, extra_shape.data());
+
+  // select a hyperslap
+  H5::DataSpace fspace = dataset.getSpace();
+  fspace.selectHyperslab(H5S_SELECT_SET, extra_shape.data(), offset.data());
+
+  // allocate output
+  T out;
+
+  // read data from the hyperslap
+  dataset.read(&out, HT, extra_datasape, fspace);
+
+  return out;
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline T File::read(std::string path, size_t index)
+{
+  return read<T>(path,getType<T>(),index);
+}
+
+// ====================== TEMPLATE TO WRITE ARRAY OF ARBITRARY SHAPE OR RANK =======================
+
+template<typename T>
+inline void File::write(
+  std::string path, const T *input, const H5::DataType& HT, const std::vector<size_t> &shape
+)
+{
+  write(path,input,HT,shape,m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::write(
+  std::string path, const T *input, const H5::DataType& HT, const std::vector<size_t> &shape,
+  const DataSetOptions &options
+)
+{
+  // check existence of path
+  if ( exists(path) )
+    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
+
+  // add dataset to file
+  H5::DataSet dataset = createArray(path, HT, shape, options, sizeof(T));
+
+  // store data
+  writeData(dataset, path, input, HT);
+
+  // flush the file if so requested
+  autoflush(size(dataset)*sizeof(T));
+}
+
+// ==================== TEMPLATE TO OVERWRITE ARRAY OF ARBITRARY SHAPE OR RANK =====================
+
+template<typename T>
+inline void File::overwrite(
+  std::string path, const T *input, const H5::DataType& HT, const std::vector<size_t> &shape
+)
+{
+  // new dataset: write using normal function
+  if ( ! exists(path) ) return write<T>(path,input,HT,shape);
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::overwrite: precision inconsistent ('"+path+"')");
+  #endif
+
+  // check shape
+  if ( this->shape(dataset) != shape )
+    throw std::runtime_error("HDF5pp::overwrite: shape inconsistent ('"+path+"')");
+
+  // store data
+  writeData(dataset, path, input, HT);
+
+  // flush the file if so requested
+  autoflush(size(dataset)*sizeof(T));
+}
+
+// ======================== WRITE HYPERSLAB TO DATASET (OF ARBITRARY RANK) =========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::overwrite_slice(std::string path, const T *input, const H5::DataType& HT,
+  const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &stride)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::overwrite_slice: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::overwrite_slice: precision inconsistent ('"+path+"')");
+  #endif
+
+  // extend the dataset if needed (and allowed)
+  extendDataSet(dataset, start, count, stride);
+
+  // select the hyperslab in the file
+  H5::DataSpace fspace = hyperslab(dataset, path, start, count, stride);
+
+  // define the data-space in memory
+  std::vector<hsize_t> mdims(count.begin(), count.end());
+
+  H5::DataSpace mspace(static_cast<int>(mdims.size()), mdims.data());
+
+  // write data to the hyperslab
+  dataset.write(input, HT, mspace, fspace, m_xfer);
+
+  // flush the file if so requested
+  autoflush(size(mspace)*sizeof(T));
+}
+
+// ------------------------------------------ std::vector ------------------------------------------
+
+template<typename T>
+inline void File::overwrite_slice(std::string path, const std::vector<T> &input,
+  const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &stride)
+{
+  // check size
+  size_t n = 1;
+
+  for ( auto &i : count ) n *= i;
+
+  if ( input.size() != n )
+    throw std::runtime_error("HDF5pp::overwrite_slice: size inconsistent ('"+path+"')");
+
+  // write to file
+  overwrite_slice(path, input.data(), getType<T>(), start, count, stride);
+}
+
+// ---------------------------------- template: create if needed -----------------------------------
+
+template<typename T>
+inline void File::write_slice(std::string path, const T *input, const H5::DataType& HT,
+  const std::vector<size_t> &shape, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride)
+{
+  write_slice(path, input, HT, shape, start, count, stride, m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::write_slice(std::string path, const T *input, const H5::DataType& HT,
+  const std::vector<size_t> &shape, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride,
+  const DataSetOptions &options)
+{
+  // create dataset if needed
+  if ( ! exists(path) ) createArray(path, HT, shape, options, sizeof(T));
+
+  // write to file
+  overwrite_slice(path, input, HT, start, count, stride);
+}
+
+// ======================= APPEND FRAME TO EXTENDABLE DATASET (ALONG AXIS 0) =======================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::append(std::string path, const T *input, const H5::DataType& HT,
+  const std::vector<size_t> &frame)
+{
+  // see all submitted asynchronous writes
+  waitAsync();
+
+  // default storage, the chunk shape and maximum shape follow from the frame
+  DataSetOptions options = m_options;
+
+  options.chunk.clear();
+  options.max_shape.clear();
+
+  append(path, input, HT, frame, options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::append(std::string path, const T *input, const H5::DataType& HT,
+  const std::vector<size_t> &frame, const DataSetOptions &options)
+{
+  // see all submitted asynchronous writes
+  waitAsync();
+
+  // number of bytes per frame
+  size_t nbytes = sizeof(T);
+
+  for ( auto &i : frame ) nbytes *= i;
+
+  // buffer frame
+  // ------------
+
+  // add the frame to the pending frames
+  auto it = m_append.find(path);
+
+  if ( it != m_append.end() )
+  {
+    AppendBuffer &buf = it->second;
+
+    if ( buf.type == HT && buf.frame.size() && buf.frame == frame )
+    {
+      // - store frame
+      buf.data.resize((buf.n+1)*nbytes);
+
+      std::memcpy(&buf.data[buf.n*nbytes], input, nbytes);
+
+      ++buf.n;
+
+      // - write a full chunk
+      if ( (buf.start+buf.n) % buf.chunk_size == 0 ) writePending(path);
+
+      return;
+    }
+
+    // - write the pending entries before starting a new block
+    writePending(path);
+  }
+
+  // start new block
+  // ---------------
+
+  // rank of the dataset
+  size_t rank = frame.size() + 1;
+
+  // index of the first frame, chunk shape
+  size_t               start = 0;
+  std::vector<hsize_t> chunk(rank);
+
+  if ( !exists(path) )
+  {
+    // create group(s) if needed
+    createGroup(path);
+
+    // chunk shape: specified, or about 1MB
+    if ( options.chunk.size() )
+    {
+      if ( options.chunk.size() != rank )
+        throw std::runtime_error("HDF5pp::append: chunk shape inconsistent ('"+path+"')");
+
+      chunk.assign(options.chunk.begin(), options.chunk.end());
+    }
+    else if ( nbytes > 1024*1024 )
+    {
+      std::vector<hsize_t> frame_chunk = autoChunk(frame, sizeof(T));
+
+      chunk[0] = 1;
+
+      std::copy(frame_chunk.begin(), frame_chunk.end(), chunk.begin()+1);
+    }
+    else
+    {
+      chunk[0] = static_cast<hsize_t>( (1024*1024) / std::max(nbytes, sizeof(T)) );
+
+      for ( size_t i = 1 ; i < rank ; ++i )
+        chunk[i] = std::max(static_cast<hsize_t>(frame[i-1]), static_cast<hsize_t>(1));
+    }
+  }
+  else
+  {
+    // open dataset
+    H5::DataSet   dataset   = openDataSet(path);
+    H5::DataSpace dataspace = dataset.getSpace();
+
+    // check precision
+    #ifndef HDF5PP_NDEBUG_PRECISION
+      if ( ! this->correct_presision<T>(dataset) )
+        throw std::runtime_error("HDF5pp::append: precision inconsistent ('"+path+"')");
+    #endif
+
+    // read shape and maximum shape
+    std::vector<hsize_t> dims(rank), max_dims(rank);
+
+    if ( static_cast<size_t>(dataspace.getSimpleExtentNdims()) != rank )
+      throw std::runtime_error("HDF5pp::append: rank inconsistent ('"+path+"')");
+
+    dataspace.getSimpleExtentDims(dims.data(), max_dims.data());
+
+    // check that the dataset is extendable, and that the frame matches
+    if ( max_dims[0] != H5S_UNLIMITED )
+      throw std::runtime_error("HDF5pp::append: dataset not extendable ('"+path+"')");
+
+    for ( size_t i = 1 ; i < rank ; ++i )
+      if ( dims[i] != frame[i-1] )
+        throw std::runtime_error("HDF5pp::append: shape inconsistent ('"+path+"')");
+
+    // append after the last frame, write per chunk of the dataset
+    start = static_cast<size_t>(dims[0]);
+
+    dataset.getCreatePlist().getChunk(static_cast<int>(rank), chunk.data());
+  }
+
+  // number of frames per chunk
+  size_t chunk_size = std::max(static_cast<size_t>(chunk[0]), static_cast<size_t>(1));
+
+  // allocate block, store the first frame
+  AppendBuffer buf{HT, frame, start, 1, chunk_size, chunk, options, std::vector<char>(),
+    std::vector<char>(nbytes)};
+
+  std::memcpy(buf.data.data(), input, nbytes);
+
+  m_append.emplace(path, std::move(buf));
+
+  // write a full chunk
+  if ( (start+1) % chunk_size == 0 ) writePending(path);
+}
+
+// ------------------------------------------ std::vector ------------------------------------------
+
+template<typename T>
+inline void File::append(std::string path, const std::vector<T> &input,
+  const std::vector<size_t> &frame)
+{
+  // default frame == size of input
+  std::vector<size_t> shape = frame;
+
+  if ( shape.size() == 0 ) shape.push_back(input.size());
+
+  // check size
+  size_t n = 1;
+
+  for ( auto &i : shape ) n *= i;
+
+  if ( input.size() != n )
+    throw std::runtime_error("HDF5pp::append: size inconsistent ('"+path+"')");
+
+  // append
+  append(path, input.data(), getType<T>(), shape);
+}
+
+// ======================= WRITE STD::VECTOR TO DATASET (OF ARBITRARY RANK) ========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path, const std::vector<T> &input, const H5::DataType& HT,
+  const std::vector<size_t> &shape)
+{
+  write(path,input,HT,shape,m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path, const std::vector<T> &input, const H5::DataType& HT,
+  const std::vector<size_t> &shape, const DataSetOptions &options)
+{
+  // copy input shape
+  std::vector<size_t> dims = shape;
+
+  // default shape == size of input
+  if ( dims.size() == 0 )
+  {
+    dims.resize(1);
+    dims[0] = input.size();
+  }
+
+  // write to file
+  write(path,input.data(),HT,dims,options);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::write(
+  std::string path, const std::vector<T> &input, const std::vector<size_t> &shape
+)
+{
+  return write(path,input,getType<T>(),shape);
+}
+
+// ===================== OVERWRITE STD::VECTOR TO DATASET (OF ARBITRARY RANK) ======================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::overwrite(std::string path, const std::vector<T> &input, const H5::DataType& HT,
+  const std::vector<size_t> &shape)
+{
+  // copy input shape
+  std::vector<size_t> dims = shape;
+
+  // default shape == size of input
+  if ( dims.size() == 0 )
+  {
+    dims.resize(1);
+    dims[0] = input.size();
+  }
+
+  // write to file
+  overwrite(path,input.data(),HT,dims);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::overwrite(
+  std::string path, const std::vector<T> &input, const std::vector<size_t> &shape
+)
+{
+  return overwrite(path,input,getType<T>(),shape);
+}
+
+// ======================= READ STD::VECTOR FROM DATASET (OF ARBITRARY RANK) =======================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline std::vector<T> File::read_vector(std::string path, const H5::DataType& HT)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
+  #endif
+
+  // allocate output
+  std::vector<T> data(this->size(dataset));
+
+  // read data
+  readData(dataset, path, data.data(), HT);
+
+  // return output
+  return data;
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline std::vector<T> File::read_impl(std::string path, Tag<std::vector<T>>)
+{
+  return read_vector<T>(path,getType<T>());
+}
+
+// ======================== READ DATASET INTO AN EXISTING BUFFER/CONTAINER =========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::read_into(std::string path, T *output, const H5::DataType& HT, size_t size)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read_into: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read_into: precision inconsistent ('"+path+"')");
+  #endif
+
+  // check size
+  if ( this->size(dataset) != size )
+    throw std::runtime_error("HDF5pp::read_into: size inconsistent ('"+path+"')");
+
+  // read data
+  readData(dataset, path, output, HT);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::read_into(std::string path, T *output, size_t size)
+{
+  read_into(path, output, getType<T>(), size);
+}
+
+// ------------------------------------------ std::vector ------------------------------------------
+
+template<typename T>
+inline void File::read_into(std::string path, std::vector<T> &output)
+{
+  // resize output if needed (no-op if the size matches)
+  output.resize(size(path));
+
+  // read data
+  read_into(path, output.data(), getType<T>(), output.size());
+}
+
+// ======================== READ HYPERSLAB FROM DATASET (OF ARBITRARY RANK) ========================
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::read_slice(std::string path, T *output, const H5::DataType& HT,
+  const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &stride)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read_slice: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read_slice: precision inconsistent ('"+path+"')");
+  #endif
+
+  // select the hyperslab in the file
+  H5::DataSpace fspace = hyperslab(dataset, path, start, count, stride);
+
+  // define the data-space in memory
+  std::vector<hsize_t> dims(count.begin(), count.end());
+
+  H5::DataSpace mspace(static_cast<int>(dims.size()), dims.data());
+
+  // read data from the hyperslab
+  dataset.read(output, HT, mspace, fspace);
+}
+
+// ------------------------------------------ std::vector ------------------------------------------
+
+template<typename T>
+inline std::vector<T> File::read_slice(std::string path, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride)
+{
+  // allocate output
+  size_t n = 1;
+
+  for ( auto &i : count ) n *= i;
+
+  std::vector<T> data(n);
+
+  // read data
+  read_slice(path, data.data(), getType<T>(), start, count, stride);
+
+  return data;
+}
+
+// ================================= WRITE EIGEN COLUMN TO DATASET =================================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input, const H5::DataType& HT)
+{
+  write(path,input,HT,m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input, const H5::DataType& HT,
+  const DataSetOptions &options)
+{
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // set shape
+  std::vector<size_t> shape(1, input.size());
+
+  // write to file
+  write(path,input.data(),HT,shape,options);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::write(
+  std::string path, const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+{
+  return write(path,input,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ================================= WRITE EIGEN MATRIX TO DATASET =================================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input,
+  const H5::DataType& HT)
+{
+  write(path,input,HT,m_options);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input,
+  const H5::DataType& HT, const DataSetOptions &options)
+{
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // set shape
+  std::vector<size_t> shape(2);
+  shape[0] = input.rows();
+  shape[1] = input.cols();
+
+  // write to file
+  write(path,input.data(),HT,shape,options);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::write(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+{
+  return write(path,input,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ============================ APPEND EIGEN COLUMN OR MATRIX AS FRAME =============================
+
+#ifdef HDF5PP_EIGEN
+
+// -------------------------------------------- column ---------------------------------------------
+
+template<typename T>
+inline void File::append(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+{
+  std::vector<size_t> frame(1, input.size());
+
+  append(path, input.data(), getType<T>(), frame);
+}
+
+// -------------------------------------------- matrix ---------------------------------------------
+
+template<typename T>
+inline void File::append(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+{
+  std::vector<size_t> frame(2);
+  frame[0] = input.rows();
+  frame[1] = input.cols();
+
+  append(path, input.data(), getType<T>(), frame);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// =============================== OVERWRITE EIGEN COLUMN TO DATASET ===============================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::overwrite(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input, const H5::DataType& HT)
+{
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // set shape
+  std::vector<size_t> shape(1, input.size());
+
+  // overwrite to file
+  overwrite(path,input.data(),HT,shape);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::overwrite(
+  std::string path, const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+{
+  return overwrite(path,input,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// =============================== OVERWRITE EIGEN MATRIX TO DATASET ===============================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::overwrite(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input,
+  const H5::DataType& HT)
+{
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // set shape
+  std::vector<size_t> shape(2);
+  shape[0] = input.rows();
+  shape[1] = input.cols();
+
+  // overwrite to file
+  overwrite(path,input.data(),HT,shape);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline void File::overwrite(std::string path,
+  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+{
+  return overwrite(path,input,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ================================= READ TO DATASET EIGEN COLUMN ==================================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> File::read_eigen_column(std::string path,
+  const H5::DataType& HT)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
+  #endif
+
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // allocate output
+  Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> data(this->size(dataset));
+
+  // read data
+  readData(dataset, path, data.data(), HT);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+
+  // return output
+  return data;
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor>
+File::read_impl(std::string path, Tag<Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor>>)
+{
+  return read_eigen_column<T>(path,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ================================= READ TO DATASET EIGEN MATRIX ==================================
+
+#ifdef HDF5PP_EIGEN
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
+File::read_eigen_matrix(std::string path, const H5::DataType& HT)
+{
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
+  #endif
+
+  // get shape
+  std::vector<size_t> shape = this->shape(dataset);
+
+  // check rank
+  if ( shape.size() != 2 )
+    throw std::runtime_error("HDF5pp::read: dataset has a rank different than 2 ('"+path+"')");
+
+  // temporarily disable parallelization by Eigen (just in case)
+  Eigen::setNbThreads(1);
+
+  // allocate output
+  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> data(shape[0], shape[1]);
+
+  // read data
+  readData(dataset, path, data.data(), HT);
+
+  // reset automatic parallelization by Eigen
+  Eigen::setNbThreads(0);
+
+  // return output
+  return data;
+}
+
+// --------------------------------------- registered types ----------------------------------------
+
+template<typename T>
+inline Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
+File::read_impl(std::string path,
+  Tag<Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>)
+{
+  return read_eigen_matrix<T>(path,getType<T>());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ===================== READ DATASET INTO AN EXISTING EIGEN COLUMN OR MATRIX ======================
+
+#ifdef HDF5PP_EIGEN
+
+// -------------------------------------------- column ---------------------------------------------
+
+template<typename T>
+inline void File::read_into(std::string path,
+  Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &output)
+{
+  // resize output if needed
+  size_t n = size(path);
+
+  if ( static_cast<size_t>(output.size()) != n ) output.resize(n);
+
+  // read data
+  read_into(path, output.data(), getType<T>(), n);
+}
+
+// -------------------------------------------- matrix ---------------------------------------------
+
+template<typename T>
+inline void File::read_into(std::string path,
+  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &output)
+{
+  // get shape
+  std::vector<size_t> shape = this->shape(path);
+
+  // check rank
+  if ( shape.size() != 2 )
+    throw std::runtime_error("HDF5pp::read_into: dataset has a rank different than 2 ('"+path+"')");
+
+  // resize output if needed
+  if ( static_cast<size_t>(output.rows()) != shape[0] ||
+       static_cast<size_t>(output.cols()) != shape[1] )
+    output.resize(shape[0], shape[1]);
+
+  // read data
+  read_into(path, output.data(), getType<T>(), shape[0]*shape[1]);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+#endif
+
+// ======================= WRITE CPPMAT-ND-ARRAY TO DATASET OF MATCHING RANK =======================
+
+#ifdef HDF5PP_CPPMAT
+
+// ------------------------------------------- template --------------------------------------------
+
+template<typename T>
+inline void File::write(std::string path, const cppmat::array<T> &input, const H5::DataType& HT)
 {
-  return write(path,input,H5::PredType::NATIVE_FLOAT,shape);
+  write(path,input.data(),HT,input.shape(),m_options);
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::write(
-  std::string path, const std::vector<double> &input, const std::vector<size_t> &shape
-)
+template<typename T>
+inline void File::write(std::string path, const cppmat::array<T> &input, const H5::DataType& HT,
+  const DataSetOptions &options)
 {
-  return write(path,input,H5::PredType::NATIVE_DOUBLE,shape);
+  write(path,input.data(),HT,input.shape(),options);
 }
 
-// ===================== OVERWRITE STD::VECTOR TO DATASET (OF ARBITRARY RANK) ======================
-
-// ------------------------------------------- template --------------------------------------------
+// --------------------------------------- registered types ----------------------------------------
 
 template<typename T>
-inline void File::overwrite(std::string path, const std::vector<T> &input, const H5::PredType& HT,
-  const std::vector<size_t> &shape)
+inline void File::write(std::string path, const cppmat::array<T> &input)
 {
-  // copy input shape
-  std::vector<size_t> dims = shape;
+  return write(path,input,getType<T>());
+}
 
-  // default shape == size of input
-  if ( dims.size() == 0 )
-  {
-    dims.resize(1);
-    dims[0] = input.size();
-  }
+// -------------------------------------------------------------------------------------------------
 
-  // write to file
-  overwrite(path,input.data(),HT,dims);
-}
+#endif
 
-// ---------------------------------------------- int ----------------------------------------------
+// ===================== OVERWRITE CPPMAT-ND-ARRAY TO DATASET OF MATCHING RANK =====================
 
-inline void File::overwrite(
-  std::string path, const std::vector<int> &input, const std::vector<size_t> &shape
-)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_INT,shape);
-}
+#ifdef HDF5PP_CPPMAT
 
-// -------------------------------------------- size_t ---------------------------------------------
+// ------------------------------------------- template --------------------------------------------
 
-inline void File::overwrite(
-  std::string path, const std::vector<size_t> &input, const std::vector<size_t> &shape
-)
+template<typename T>
+inline void File::overwrite(std::string path, const cppmat::array<T> &input, const H5::DataType& HT)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_HSIZE,shape);
+  overwrite(path,input.data(),HT,input.shape());
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// --------------------------------------- registered types ----------------------------------------
 
-inline void File::overwrite(
-  std::string path, const std::vector<float> &input, const std::vector<size_t> &shape
-)
+template<typename T>
+inline void File::overwrite(std::string path, const cppmat::array<T> &input)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_FLOAT,shape);
+  return overwrite(path,input,getType<T>());
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::overwrite(
-  std::string path, const std::vector<double> &input, const std::vector<size_t> &shape
-)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_DOUBLE,shape);
-}
+#endif
 
-// ======================= READ STD::VECTOR FROM DATASET (OF ARBITRARY RANK) =======================
+// ================================= READ TO DATASET CPPMAT MATRIX =================================
+
+#ifdef HDF5PP_CPPMAT
 
 // ------------------------------------------- template --------------------------------------------
 
 template<typename T>
-inline std::vector<T> File::read_vector(std::string path, const H5::PredType& HT)
+inline cppmat::array<T> File::read_cppmat_array(std::string path, const H5::DataType& HT)
 {
   // check existence of path
   if ( ! exists(path) )
     throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
 
   // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+  H5::DataSet dataset = openDataSet(path);
 
   // check precision
   #ifndef HDF5PP_NDEBUG_PRECISION
@@ -1340,685 +5866,791 @@ inline std::vector<T> File::read_vector(std::string path, const H5::PredType& HT
   #endif
 
   // allocate output
-  std::vector<T> data(this->size(dataset));
+  cppmat::array<T> data(this->shape(dataset));
 
   // read data
-  dataset.read(const_cast<T*>(data.data()), HT);
+  readData(dataset, path, data.data(), HT);
 
   // return output
   return data;
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// --------------------------------------- registered types ----------------------------------------
 
-template<>
-inline std::vector<int> File::read<std::vector<int>>(std::string path)
+template<typename T>
+inline cppmat::array<T> File::read_impl(std::string path, Tag<cppmat::array<T>>)
 {
-  return read_vector<int>(path,H5::PredType::NATIVE_INT);
+  return read_cppmat_array<T>(path,getType<T>());
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline std::vector<size_t> File::read<std::vector<size_t>>(std::string path)
-{
-  return read_vector<size_t>(path,H5::PredType::NATIVE_HSIZE);
-}
+#endif
 
-// --------------------------------------------- float ---------------------------------------------
+// ========================== READ DATASET INTO AN EXISTING CPPMAT ARRAY ===========================
 
-template<>
-inline std::vector<float> File::read<std::vector<float>>(std::string path)
+#ifdef HDF5PP_CPPMAT
+
+template<typename T>
+inline void File::read_into(std::string path, cppmat::array<T> &output)
 {
-  return read_vector<float>(path,H5::PredType::NATIVE_FLOAT);
-}
+  // resize output if needed
+  std::vector<size_t> shape = this->shape(path);
 
-// -------------------------------------------- double ---------------------------------------------
+  if ( output.shape() != shape ) output.resize(shape);
 
-template<>
-inline std::vector<double> File::read<std::vector<double>>(std::string path)
-{
-  return read_vector<double>(path,H5::PredType::NATIVE_DOUBLE);
+  // read data
+  read_into(path, output.data(), getType<T>(), output.size());
 }
 
-// ================================= WRITE EIGEN COLUMN TO DATASET =================================
+#endif
 
-#ifdef HDF5PP_EIGEN
+// ========================================= WRITE XTENSOR =========================================
 
-// ------------------------------------------- template --------------------------------------------
+#ifdef HDF5PP_XTENSOR
 
-template<typename T>
-inline void File::write(std::string path,
-  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input, const H5::PredType& HT)
-{
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+// (internal) "std::true_type" for a container whose buffer is contiguous and row-major, such that
+// it can be written without copy, "std::false_type" otherwise (e.g. for lazy expressions and views)
+template<class E, bool = std::is_base_of<xt::xcontainer<E>, E>::value>
+struct xcontiguous : std::false_type {};
 
-  // set shape
-  std::vector<size_t> shape(1, input.size());
+template<class E>
+struct xcontiguous<E,true> :
+  std::integral_constant<bool, E::static_layout == xt::layout_type::row_major> {};
 
-  // write to file
-  write(path,input.data(),HT,shape);
+// -------------------------------------------------------------------------------------------------
 
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
+template<class E>
+inline void File::write(std::string path, const xt::xexpression<E> &data)
+{
+  write(path, data, m_options);
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::write(
-  std::string path, const Eigen::Matrix<int,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+template<class E>
+inline void File::write(std::string path, const xt::xexpression<E> &data,
+  const DataSetOptions &options)
 {
-  return write(path,input,H5::PredType::NATIVE_INT);
-}
+  using T = typename E::value_type;
 
-// -------------------------------------------- size_t ---------------------------------------------
+  const E& d_data = data.derived_cast();
 
-inline void File::write(
-  std::string path, const Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_HSIZE);
-}
+  std::vector<size_t> shape(d_data.shape().cbegin(), d_data.shape().cend());
+
+  // check existence of path
+  if ( exists(path) )
+    throw std::runtime_error("HDF5pp::write: path already exists ('"+path+"')");
 
-// --------------------------------------------- float ---------------------------------------------
+  // add dataset to file
+  H5::DataSet dataset = createArray(path, getType<T>(), shape, options, sizeof(T));
 
-inline void File::write(
-  std::string path, const Eigen::Matrix<float,Eigen::Dynamic,1,Eigen::ColMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_FLOAT);
+  // store data
+  xwrite_impl(dataset, path, d_data, {}, {}, xcontiguous<E>());
+
+  // flush the file if so requested
+  autoflush(size(dataset)*sizeof(T));
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// ----------------------------- write without evaluating a temporary ------------------------------
 
-inline void File::write(
-  std::string path, const Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+template<class E>
+inline void File::xwrite_impl(H5::DataSet &dataset, const std::string &path, const E &data,
+  const std::vector<size_t> &start, const std::vector<size_t> &stride, std::true_type)
 {
-  return write(path,input,H5::PredType::NATIVE_DOUBLE);
+  using T = typename E::value_type;
+
+  // write the entire dataset
+  if ( start.empty() ) return writeData(dataset, path, data.data(), getType<T>());
+
+  // select the hyperslab in the file
+  std::vector<size_t> count(data.shape().cbegin(), data.shape().cend());
+
+  H5::DataSpace fspace = hyperslab(dataset, path, start, count, stride);
+
+  // define the data-space in memory
+  std::vector<hsize_t> mdims(count.begin(), count.end());
+
+  H5::DataSpace mspace(static_cast<int>(mdims.size()), mdims.data());
+
+  // write data to the hyperslab
+  dataset.write(data.data(), getType<T>(), mspace, fspace, m_xfer);
 }
 
 // -------------------------------------------------------------------------------------------------
 
-#endif
+template<class E>
+inline void File::xwrite_impl(H5::DataSet &dataset, const std::string &path, const E &data,
+  const std::vector<size_t> &start, const std::vector<size_t> &stride, std::false_type)
+{
+  using T = typename E::value_type;
 
-// ================================= WRITE EIGEN MATRIX TO DATASET =================================
+  // shape of the data
+  std::vector<size_t> count(data.shape().cbegin(), data.shape().cend());
 
-#ifdef HDF5PP_EIGEN
+  // collective writes (MPI): a single write, as the number of blocks may differ between processes
+  #ifdef HDF5PP_MPI
+    if ( m_mpi && start.size() )
+    {
+      xt::xarray<T> tmp = data;
 
-// ------------------------------------------- template --------------------------------------------
+      return xwrite_impl(dataset, path, tmp, start, stride, std::true_type());
+    }
+  #endif
 
-template<typename T>
-inline void File::write(std::string path,
-  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input,
-  const H5::PredType& HT)
-{
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+  // scalar: write its only entry
+  if ( count.empty() )
+  {
+    T value = *data.cbegin();
 
-  // set shape
-  std::vector<size_t> shape(2);
-  shape[0] = input.rows();
-  shape[1] = input.cols();
+    return dataset.write(&value, getType<T>());
+  }
 
-  // write to file
-  write(path,input.data(),HT,shape);
+  // number of entries per row (along the first axis), number of rows per block
+  size_t row = 1;
 
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
-}
+  for ( size_t i = 1 ; i < count.size() ; ++i ) row *= count[i];
 
-// ---------------------------------------------- int ----------------------------------------------
+  if ( row == 0 || count[0] == 0 ) return;
 
-inline void File::write(std::string path,
-  const Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_INT);
-}
+  size_t nrow = std::max((1024*1024) / (row*sizeof(T)), static_cast<size_t>(1));
 
-// -------------------------------------------- size_t ---------------------------------------------
+  nrow = std::min(nrow, count[0]);
 
-inline void File::write(std::string path,
-  const Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_HSIZE);
-}
+  // allocate staging buffer
+  std::vector<T> buffer(nrow*row);
 
-// --------------------------------------------- float ---------------------------------------------
+  // hyperslab of a block
+  std::vector<size_t> offset = start;
 
-inline void File::write(std::string path,
-  const Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_FLOAT);
-}
+  if ( offset.empty() ) offset.resize(count.size(), 0);
 
-// -------------------------------------------- double ---------------------------------------------
+  std::vector<size_t> block = count;
 
-inline void File::write(std::string path,
-  const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_DOUBLE);
-}
+  size_t step = stride.size() ? stride[0] : 1;
 
-// -------------------------------------------------------------------------------------------------
+  // write per block of rows
+  for ( size_t i = 0 ; i < count[0] ; i += nrow )
+  {
+    size_t n = std::min(nrow, count[0]-i);
 
-#endif
+    // - evaluate the block in the staging buffer (row-major)
+    auto view = xt::view(data, xt::range(i, i+n));
 
-// =============================== OVERWRITE EIGEN COLUMN TO DATASET ===============================
+    std::copy(view.cbegin(), view.cend(), buffer.begin());
 
-#ifdef HDF5PP_EIGEN
+    // - select the hyperslab in the file
+    block[0] = n;
 
-// ------------------------------------------- template --------------------------------------------
+    std::vector<size_t> first = offset;
 
-template<typename T>
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> &input, const H5::PredType& HT)
-{
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+    first[0] += i * step;
 
-  // set shape
-  std::vector<size_t> shape(1, input.size());
+    H5::DataSpace fspace = hyperslab(dataset, path, first, block, stride);
 
-  // overwrite to file
-  overwrite(path,input.data(),HT,shape);
+    // - define the data-space in memory
+    std::vector<hsize_t> mdims(block.begin(), block.end());
 
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
+    H5::DataSpace mspace(static_cast<int>(mdims.size()), mdims.data());
+
+    // - write data to the hyperslab
+    dataset.write(buffer.data(), getType<T>(), mspace, fspace, m_xfer);
+  }
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+#endif
 
-inline void File::overwrite(
-  std::string path, const Eigen::Matrix<int,Eigen::Dynamic,1,Eigen::ColMajor> &input)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_INT);
-}
+// ======================================= OVERWRITE XTENSOR =======================================
 
-// -------------------------------------------- size_t ---------------------------------------------
+#ifdef HDF5PP_XTENSOR
 
-inline void File::overwrite(
-  std::string path, const Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+template<class E>
+inline void File::overwrite(std::string path, const xt::xexpression<E> &data)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_HSIZE);
+  using T = typename E::value_type;
+
+  // new dataset: write using normal function
+  if ( ! exists(path) ) return write(path, data);
+
+  const E& d_data = data.derived_cast();
+
+  std::vector<size_t> shape(d_data.shape().cbegin(), d_data.shape().cend());
+
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
+
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::overwrite: precision inconsistent ('"+path+"')");
+  #endif
+
+  // check shape
+  if ( this->shape(dataset) != shape )
+    throw std::runtime_error("HDF5pp::overwrite: shape inconsistent ('"+path+"')");
+
+  // store data
+  xwrite_impl(dataset, path, d_data, {}, {}, xcontiguous<E>());
+
+  // flush the file if so requested
+  autoflush(size(dataset)*sizeof(T));
 }
 
-// --------------------------------------------- float ---------------------------------------------
+#endif
+
+// ==================================== APPEND XTENSOR AS FRAME ====================================
 
-inline void File::overwrite(
-  std::string path, const Eigen::Matrix<float,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+#ifdef HDF5PP_XTENSOR
+
+template<class E>
+inline void File::append(std::string path, const xt::xexpression<E> &data)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_FLOAT);
+  auto&& d_data = xt::eval(data.derived_cast());
+
+  std::vector<size_t> frame(d_data.shape().cbegin(), d_data.shape().cend());
+
+  append(path, d_data.data(), getType<typename E::value_type>(), frame);
 }
 
-// -------------------------------------------- double ---------------------------------------------
+#endif
 
-inline void File::overwrite(
-  std::string path, const Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor> &input)
+// ==================================== WRITE HYPERSLAB XTENSOR ====================================
+
+#ifdef HDF5PP_XTENSOR
+
+template<class E>
+inline void File::overwrite_slice(std::string path, const xt::xexpression<E> &data,
+  const std::vector<size_t> &start, const std::vector<size_t> &stride)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_DOUBLE);
-}
+  using T = typename E::value_type;
 
-// -------------------------------------------------------------------------------------------------
+  const E& d_data = data.derived_cast();
 
-#endif
+  std::vector<size_t> count(d_data.shape().cbegin(), d_data.shape().cend());
 
-// =============================== OVERWRITE EIGEN MATRIX TO DATASET ===============================
+  // check existence of path
+  if ( ! exists(path) )
+    throw std::runtime_error("HDF5pp::overwrite_slice: dataset not found ('"+path+"')");
 
-#ifdef HDF5PP_EIGEN
+  // open dataset
+  H5::DataSet dataset = openDataSet(path);
 
-// ------------------------------------------- template --------------------------------------------
+  // check precision
+  #ifndef HDF5PP_NDEBUG_PRECISION
+    if ( ! this->correct_presision<T>(dataset) )
+      throw std::runtime_error("HDF5pp::overwrite_slice: precision inconsistent ('"+path+"')");
+  #endif
 
-template<typename T>
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input,
-  const H5::PredType& HT)
-{
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+  // check rank (the hyperslab of each block is checked when it is written)
+  if ( start.size() != count.size() )
+    throw std::runtime_error("HDF5pp::overwrite_slice: rank inconsistent ('"+path+"')");
 
-  // set shape
-  std::vector<size_t> shape(2);
-  shape[0] = input.rows();
-  shape[1] = input.cols();
+  // extend the dataset if needed (and allowed)
+  extendDataSet(dataset, start, count, stride);
 
-  // overwrite to file
-  overwrite(path,input.data(),HT,shape);
+  // write data to the hyperslab
+  xwrite_impl(dataset, path, d_data, start, stride, xcontiguous<E>());
 
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
-}
+  // flush the file if so requested
+  size_t n = 1;
 
-// ---------------------------------------------- int ----------------------------------------------
+  for ( auto &i : count ) n *= i;
 
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_INT);
+  autoflush(n*sizeof(T));
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+template<class E>
+inline void File::write_slice(std::string path, const xt::xexpression<E> &data,
+  const std::vector<size_t> &shape, const std::vector<size_t> &start,
+  const std::vector<size_t> &stride)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_HSIZE);
+  using T = typename E::value_type;
+
+  // create dataset if needed
+  if ( ! exists(path) ) createArray(path, getType<T>(), shape, m_options, sizeof(T));
+
+  // write the hyperslab
+  overwrite_slice(path, data, start, stride);
 }
 
-// --------------------------------------------- float ---------------------------------------------
+#endif
 
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+// ========================================= READ XTENSOR ==========================================
+
+#ifdef HDF5PP_XTENSOR
+
+// -------------------------------------------------------------------------------------------------
+
+template<class T>
+inline auto File::xread(const std::string& path)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_FLOAT);
+  return xread_impl<xt::xarray<T>>(path, getType<T>());
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::overwrite(std::string path,
-  const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &input)
+template<class T, size_t N>
+inline auto File::xread(const std::string& path)
 {
-  return overwrite(path,input,H5::PredType::NATIVE_DOUBLE);
+  return xread_impl<xt::xtensor<T,N>>(path, getType<T>());
 }
 
 // -------------------------------------------------------------------------------------------------
 
-#endif
-
-// ================================= READ TO DATASET EIGEN COLUMN =================================
-
-#ifdef HDF5PP_EIGEN
-
-// ------------------------------------------- template --------------------------------------------
-
-template<typename T>
-inline Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> File::read_eigen_column(std::string path,
-  const H5::PredType& HT)
+template <class T>
+inline T File::xread_impl(const std::string& path, const H5::DataType& HT)
 {
   // check existence of path
   if ( ! exists(path) )
     throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
 
   // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
-
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
-  #endif
-
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+  H5::DataSet dataset = openDataSet(path);
 
   // allocate output
-  Eigen::Matrix<T,Eigen::Dynamic,1,Eigen::ColMajor> data(this->size(dataset));
+  T data = T::from_shape(this->shape(dataset));
 
   // read data
-  dataset.read(data.data(), HT);
-
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
+  readData(dataset, path, data.data(), HT);
 
   // return output
   return data;
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<int,Eigen::Dynamic,1,Eigen::ColMajor>
-File::read<Eigen::Matrix<int,Eigen::Dynamic,1,Eigen::ColMajor>>(std::string path)
+template<class T>
+inline auto File::xread_slice(const std::string& path, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride)
 {
-  return read_eigen_column<int>(path,H5::PredType::NATIVE_INT);
-}
+  xt::xarray<T> data = xt::xarray<T>::from_shape(count);
 
-// -------------------------------------------- size_t ---------------------------------------------
+  read_slice(path, data.data(), getType<T>(), start, count, stride);
 
-template<>
-inline Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor>
-File::read<Eigen::Matrix<size_t,Eigen::Dynamic,1,Eigen::ColMajor>>(std::string path)
-{
-  return read_eigen_column<size_t>(path,H5::PredType::NATIVE_HSIZE);
+  return data;
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<float,Eigen::Dynamic,1,Eigen::ColMajor>
-File::read<Eigen::Matrix<float,Eigen::Dynamic,1,Eigen::ColMajor>>(std::string path)
+template<class T, size_t N>
+inline auto File::xread_slice(const std::string& path, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, const std::vector<size_t> &stride)
 {
-  return read_eigen_column<float>(path,H5::PredType::NATIVE_FLOAT);
-}
+  xt::xtensor<T,N> data = xt::xtensor<T,N>::from_shape(count);
 
-// -------------------------------------------- double ---------------------------------------------
+  read_slice(path, data.data(), getType<T>(), start, count, stride);
 
-template<>
-inline Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor>
-File::read<Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor>>(std::string path)
-{
-  return read_eigen_column<double>(path,H5::PredType::NATIVE_DOUBLE);
+  return data;
 }
 
 // -------------------------------------------------------------------------------------------------
 
-#endif
+template<class T>
+inline void File::xread_slice(const std::string& path, T &output,
+  const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &stride)
+{
+  static_assert(T::static_layout == xt::layout_type::row_major,
+    "HDF5pp::xread_slice: output must be row-major");
 
-// ================================= READ TO DATASET EIGEN MATRIX ==================================
+  // resize output if needed
+  if ( output.dimension() != count.size() ||
+       !std::equal(count.begin(), count.end(), output.shape().begin()) )
+    output.resize(count);
 
-#ifdef HDF5PP_EIGEN
+  // read data
+  read_slice(path, output.data(), getType<typename T::value_type>(), start, count, stride);
+}
 
-// ------------------------------------------- template --------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<typename T>
-inline Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
-File::read_eigen_matrix(std::string path, const H5::PredType& HT)
+template<class T>
+inline void File::read_into(std::string path, xt::xarray<T> &output)
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+  // resize output if needed
+  std::vector<size_t> shape = this->shape(path);
 
-  // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+  if ( output.dimension() != shape.size() ||
+       !std::equal(shape.begin(), shape.end(), output.shape().begin()) )
+    output.resize(shape);
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
-  #endif
+  // read data
+  read_into(path, output.data(), getType<T>(), output.size());
+}
+
+// -------------------------------------------------------------------------------------------------
 
+template<class T, size_t N>
+inline void File::read_into(std::string path, xt::xtensor<T,N> &output)
+{
   // get shape
-  std::vector<size_t> shape = this->shape(dataset);
+  std::vector<size_t> shape = this->shape(path);
 
   // check rank
-  if ( shape.size() != 2 )
-    throw std::runtime_error("HDF5pp::read: dataset has a rank different than 2 ('"+path+"')");
+  if ( shape.size() != N )
+    throw std::runtime_error("HDF5pp::read_into: rank inconsistent ('"+path+"')");
 
-  // temporarily disable parallelization by Eigen (just in case)
-  Eigen::setNbThreads(1);
+  // resize output if needed
+  if ( !std::equal(shape.begin(), shape.end(), output.shape().begin()) )
+  {
+    std::array<size_t,N> new_shape;
 
-  // allocate output
-  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> data(shape[0], shape[1]);
+    std::copy(shape.begin(), shape.end(), new_shape.begin());
+
+    output.resize(new_shape);
+  }
 
   // read data
-  dataset.read(data.data(), HT);
+  read_into(path, output.data(), getType<T>(), output.size());
+}
 
-  // reset automatic parallelization by Eigen
-  Eigen::setNbThreads(0);
+// -------------------------------------------------------------------------------------------------
 
-  // return output
-  return data;
+#endif
+
+// ======================================= ENSEMBLE OF FILES =======================================
+
+inline Ensemble::Ensemble(const std::vector<std::string> &files, size_t workers, Pool pool) :
+  m_files(files), m_pool(pool)
+{
+  #ifndef HDF5PP_FORK
+    if ( pool == Processes )
+      throw std::runtime_error("HDF5pp::Ensemble: processes not supported on this platform");
+  #endif
+
+  #ifndef H5_HAVE_THREADSAFE
+    if ( pool == Threads )
+      throw std::runtime_error("HDF5pp::Ensemble: threads require a thread-safe HDF5 library");
+  #endif
+
+  // number of workers: by default the number of cores, at most the number of files
+  if ( workers == 0 ) workers = static_cast<size_t>(std::thread::hardware_concurrency());
+
+  m_workers = std::max(static_cast<size_t>(1), std::min(workers, m_files.size()));
+
+  if ( m_pool == Serial ) m_workers = 1;
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
-File::read<Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>(std::string path)
+inline const std::vector<std::string>& Ensemble::files() const
 {
-  return read_eigen_matrix<int>(path,H5::PredType::NATIVE_INT);
+  return m_files;
 }
 
-// -------------------------------------------- size_t ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
-File::read<Eigen::Matrix<size_t,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>(std::string path)
+inline size_t Ensemble::size() const
 {
-  return read_eigen_matrix<size_t>(path,H5::PredType::NATIVE_HSIZE);
+  return m_files.size();
 }
 
-// --------------------------------------------- float ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
-File::read<Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>(std::string path)
+inline size_t Ensemble::workers() const
 {
-  return read_eigen_matrix<float>(path,H5::PredType::NATIVE_FLOAT);
+  return m_workers;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-template<>
-inline Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>
-File::read<Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>>(std::string path)
+inline Ensemble::Pool Ensemble::pool() const
 {
-  return read_eigen_matrix<double>(path,H5::PredType::NATIVE_DOUBLE);
+  return m_pool;
 }
 
 // -------------------------------------------------------------------------------------------------
 
-#endif
+inline std::vector<size_t> Ensemble::shape(const std::string &path) const
+{
+  if ( m_files.size() == 0 )
+    throw std::runtime_error("HDF5pp::Ensemble: no files ('"+path+"')");
 
-// ======================= WRITE CPPMAT-ND-ARRAY TO DATASET OF MATCHING RANK =======================
+  File file(m_files[0], "r");
 
-#ifdef HDF5PP_CPPMAT
+  if ( ! file.exists(path) )
+    throw std::runtime_error("HDF5pp::Ensemble: dataset not found ('"+m_files[0]+":"+path+"')");
 
-// ------------------------------------------- template --------------------------------------------
+  std::vector<size_t> shape = file.shape(path);
 
-template<typename T>
-inline void File::write(std::string path, const cppmat::array<T> &input, const H5::PredType& HT)
-{
-  write(path,input.data(),HT,input.shape());
+  shape.insert(shape.begin(), m_files.size());
+
+  return shape;
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::write(std::string path, const cppmat::array<int> &input)
+template<typename T>
+inline std::vector<T> Ensemble::read(const std::string &path) const
 {
-  return write(path,input,H5::PredType::NATIVE_INT);
-}
+  std::vector<size_t> shape = this->shape(path);
 
-// -------------------------------------------- size_t ---------------------------------------------
+  size_t n = 1;
 
-inline void File::write(std::string path, const cppmat::array<size_t> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_HSIZE);
-}
+  for ( auto &i : shape ) n *= i;
 
-// --------------------------------------------- float ---------------------------------------------
+  std::vector<T> out(n);
 
-inline void File::write(std::string path, const cppmat::array<float> &input)
-{
-  return write(path,input,H5::PredType::NATIVE_FLOAT);
+  read(std::vector<std::string>{path}, std::vector<T*>{out.data()});
+
+  return out;
 }
 
-// -------------------------------------------- double ---------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::write(std::string path, const cppmat::array<double> &input)
+template<typename T>
+inline void Ensemble::read(const std::vector<std::string> &paths,
+  const std::vector<T*> &outputs) const
 {
-  return write(path,input,H5::PredType::NATIVE_DOUBLE);
-}
+  if ( paths.size() != outputs.size() )
+    throw std::runtime_error("HDF5pp::Ensemble: number of paths and outputs inconsistent");
 
-// -------------------------------------------------------------------------------------------------
+  if ( m_files.size() == 0 || paths.size() == 0 ) return;
 
-#endif
+  // shape of each dataset, read from the first file
+  std::vector<std::vector<size_t>> shapes;
 
-// ===================== OVERWRITE CPPMAT-ND-ARRAY TO DATASET OF MATCHING RANK =====================
+  {
+    File file(m_files[0], "r");
 
-#ifdef HDF5PP_CPPMAT
+    for ( auto &path : paths )
+    {
+      if ( ! file.exists(path) )
+        throw std::runtime_error("HDF5pp::Ensemble: dataset not found ('"+m_files[0]+":"+path+"')");
 
-// ------------------------------------------- template --------------------------------------------
+      shapes.push_back(file.shape(path));
+    }
+  }
 
-template<typename T>
-inline void File::overwrite(std::string path, const cppmat::array<T> &input, const H5::PredType& HT)
-{
-  overwrite(path,input.data(),HT,input.shape());
+  // read all files
+  if ( m_workers > 1 && m_pool == Processes ) return readProcesses(paths, shapes, outputs);
+  if ( m_workers > 1 && m_pool == Threads   ) return readThreads  (paths, shapes, outputs);
+
+  for ( size_t i = 0 ; i < m_files.size() ; ++i ) readFile(i, paths, shapes, outputs);
 }
 
-// ---------------------------------------------- int ----------------------------------------------
+// -------------------------------------------------------------------------------------------------
 
-inline void File::overwrite(std::string path, const cppmat::array<int> &input)
+template<typename T>
+inline void Ensemble::readFile(size_t i, const std::vector<std::string> &paths,
+  const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const
 {
-  return overwrite(path,input,H5::PredType::NATIVE_INT);
-}
+  const std::string &fname = m_files[i];
 
-// -------------------------------------------- size_t ---------------------------------------------
+  try
+  {
+    File file(fname, "r");
 
-inline void File::overwrite(std::string path, const cppmat::array<size_t> &input)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_HSIZE);
-}
+    for ( size_t j = 0 ; j < paths.size() ; ++j )
+    {
+      if ( ! file.exists(paths[j]) )
+        throw std::runtime_error("HDF5pp::Ensemble: dataset not found ('"+fname+":"+paths[j]+"')");
 
-// --------------------------------------------- float ---------------------------------------------
+      if ( file.shape(paths[j]) != shapes[j] )
+        throw std::runtime_error("HDF5pp::Ensemble: shape inconsistent ('"+fname+":"+paths[j]+"')");
 
-inline void File::overwrite(std::string path, const cppmat::array<float> &input)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_FLOAT);
-}
+      size_t n = 1;
 
-// -------------------------------------------- double ---------------------------------------------
+      for ( auto &k : shapes[j] ) n *= k;
 
-inline void File::overwrite(std::string path, const cppmat::array<double> &input)
-{
-  return overwrite(path,input,H5::PredType::NATIVE_DOUBLE);
+      file.read_into(paths[j], outputs[j] + i * n, n);
+    }
+  }
+  catch ( H5::Exception &e )
+  {
+    throw std::runtime_error("HDF5pp::Ensemble: "+e.getDetailMsg()+" ('"+fname+"')");
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
 
-#endif
+template<typename T>
+inline void Ensemble::readThreads(const std::vector<std::string> &paths,
+  const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const
+{
+  // each worker reads the next file that is not yet read, until the first error
+  std::atomic<size_t>             next(0);
+  std::vector<std::exception_ptr> errors(m_workers);
+  std::vector<std::thread>        threads;
 
-// ================================= READ TO DATASET CPPMAT MATRIX =================================
+  for ( size_t w = 0 ; w < m_workers ; ++w )
+  {
+    threads.emplace_back([this, w, &next, &errors, &paths, &shapes, &outputs]()
+    {
+      try
+      {
+        for ( size_t i = next++ ; i < m_files.size() ; i = next++ )
+          readFile(i, paths, shapes, outputs);
+      }
+      catch (...)
+      {
+        errors[w] = std::current_exception();
+        next      = m_files.size();
+      }
+    });
+  }
 
-#ifdef HDF5PP_CPPMAT
+  for ( auto &thread : threads ) thread.join();
 
-// ------------------------------------------- template --------------------------------------------
+  for ( auto &error : errors )
+    if ( error ) std::rethrow_exception(error);
+}
+
+// -------------------------------------------------------------------------------------------------
 
 template<typename T>
-inline cppmat::array<T> File::read_cppmat_array(std::string path, const H5::PredType& HT)
+inline void Ensemble::readProcesses(const std::vector<std::string> &paths,
+  const std::vector<std::vector<size_t>> &shapes, const std::vector<T*> &outputs) const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
-
-  // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+  #ifndef HDF5PP_FORK
+    throw std::runtime_error("HDF5pp::Ensemble: processes not supported on this platform");
+  #else
 
-  // check precision
-  #ifndef HDF5PP_NDEBUG_PRECISION
-    if ( ! this->correct_presision<T>(dataset) )
-      throw std::runtime_error("HDF5pp::read: precision inconsistent ('"+path+"')");
-  #endif
+  // shared memory: the stacked datasets, followed by an error message per worker
+  const size_t nmsg = 512;
 
-  // allocate output
-  cppmat::array<T> data(this->shape(dataset));
+  std::vector<size_t> offset(paths.size()+1, 0);
 
-  // read data
-  dataset.read(data.data(), HT);
+  for ( size_t j = 0 ; j < paths.size() ; ++j )
+  {
+    size_t n = m_files.size();
 
-  // return output
-  return data;
-}
+    for ( auto &k : shapes[j] ) n *= k;
 
-// ---------------------------------------------- int ----------------------------------------------
+    offset[j+1] = offset[j] + n * sizeof(T);
+  }
 
-template<>
-inline cppmat::array<int> File::read<cppmat::array<int>>(std::string path)
-{
-  return read_cppmat_array<int>(path,H5::PredType::NATIVE_INT);
-}
+  size_t nbytes = offset.back() + m_workers * nmsg;
 
-// -------------------------------------------- size_t ---------------------------------------------
+  void* addr = mmap(NULL, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
 
-template<>
-inline cppmat::array<size_t> File::read<cppmat::array<size_t>>(std::string path)
-{
-  return read_cppmat_array<size_t>(path,H5::PredType::NATIVE_HSIZE);
-}
+  if ( addr == MAP_FAILED )
+    throw std::runtime_error("HDF5pp::Ensemble: unable to allocate shared memory");
 
-// --------------------------------------------- float ---------------------------------------------
+  std::shared_ptr<void> region(addr, [nbytes](void* p) { munmap(p, nbytes); });
 
-template<>
-inline cppmat::array<float> File::read<cppmat::array<float>>(std::string path)
-{
-  return read_cppmat_array<float>(path,H5::PredType::NATIVE_FLOAT);
-}
+  char* base = static_cast<char*>(addr);
+  char* msg  = base + offset.back();
 
-// -------------------------------------------- double ---------------------------------------------
+  std::vector<T*> shared(paths.size());
 
-template<>
-inline cppmat::array<double> File::read<cppmat::array<double>>(std::string path)
-{
-  return read_cppmat_array<double>(path,H5::PredType::NATIVE_DOUBLE);
-}
+  for ( size_t j = 0 ; j < paths.size() ; ++j )
+    shared[j] = reinterpret_cast<T*>(base + offset[j]);
 
-// -------------------------------------------------------------------------------------------------
+  // start the workers: worker "w" reads files "w, w + workers, ..."
+  std::vector<pid_t> pids;
 
-#endif
+  for ( size_t w = 0 ; w < m_workers ; ++w )
+  {
+    pid_t pid = fork();
 
-// ========================================= WRITE XTENSOR =========================================
+    if ( pid < 0 ) break;
 
-#ifdef HDF5PP_XTENSOR
+    if ( pid == 0 )
+    {
+      int status = 0;
+
+      try
+      {
+        for ( size_t i = w ; i < m_files.size() ; i += m_workers )
+          readFile(i, paths, shapes, shared);
+      }
+      catch ( std::exception &e )
+      {
+        std::strncpy(msg + w * nmsg, e.what(), nmsg - 1);
+        status = 1;
+      }
+      catch (...)
+      {
+        status = 1;
+      }
+
+      // exit without the exit handlers of the parent (that would close, and flush, its files)
+      _exit(status);
+    }
 
-template<class E>
-inline void File::write(std::string path, const xt::xexpression<E> &data)
-{
-  auto&& d_data = xt::eval(data.derived_cast());
+    pids.push_back(pid);
+  }
 
-  std::vector<size_t> shape(d_data.shape().cbegin(), d_data.shape().cend());
+  // wait for the workers, collect the first error
+  std::string error;
 
-  write(path, d_data.begin(), getType<typename E::value_type>(), shape);
-}
+  if ( pids.size() < m_workers ) error = "HDF5pp::Ensemble: unable to start the workers";
 
-#endif
+  for ( size_t w = 0 ; w < pids.size() ; ++w )
+  {
+    int status = 0;
 
-// ======================================= OVERWRITE XTENSOR =======================================
+    while ( waitpid(pids[w], &status, 0) < 0 && errno == EINTR ) {}
 
-#ifdef HDF5PP_XTENSOR
+    if ( error.empty() && !( WIFEXITED(status) && WEXITSTATUS(status) == 0 ) )
+    {
+      if ( msg[w * nmsg] ) error = std::string(msg + w * nmsg);
+      else                 error = "HDF5pp::Ensemble: worker terminated ('"+paths[0]+"')";
+    }
+  }
 
-template<class E>
-inline void File::overwrite(std::string path, const xt::xexpression<E> &data)
-{
-  auto&& d_data = xt::eval(data.derived_cast());
+  if ( ! error.empty() ) throw std::runtime_error(error);
 
-  std::vector<size_t> shape(d_data.shape().cbegin(), d_data.shape().cend());
+  // copy the data from the shared memory
+  for ( size_t j = 0 ; j < paths.size() ; ++j )
+    std::memcpy(outputs[j], shared[j], offset[j+1] - offset[j]);
 
-  overwrite(path, d_data.begin(), getType<typename E::value_type>(), shape);
+  #endif
 }
 
-#endif
-
-// ========================================= READ XTENSOR ==========================================
+// -------------------------------------------------------------------------------------------------
 
 #ifdef HDF5PP_XTENSOR
 
-// -------------------------------------------------------------------------------------------------
-
 template<class T>
-inline auto File::xread(const std::string& path)
+inline xt::xarray<T> Ensemble::xread(const std::string &path) const
 {
-  return xread_impl<xt::xarray<T>>(path, getType<T>());
+  xt::xarray<T> out = xt::xarray<T>::from_shape(shape(path));
+
+  read(std::vector<std::string>{path}, std::vector<T*>{out.data()});
+
+  return out;
 }
 
 // -------------------------------------------------------------------------------------------------
 
-template<class T, size_t N>
-inline auto File::xread(const std::string& path)
+template<class T>
+inline void Ensemble::read_into(const std::string &path, xt::xarray<T> &output) const
 {
-  return xread_impl<xt::xtensor<T,N>>(path, getType<T>());
+  read_into(std::vector<std::string>{path}, std::vector<xt::xarray<T>*>{&output});
 }
 
 // -------------------------------------------------------------------------------------------------
 
-template <class T>
-inline T File::xread_impl(const std::string& path, const H5::PredType& HT)
+template<class T>
+inline void Ensemble::read_into(const std::vector<std::string> &paths,
+  const std::vector<xt::xarray<T>*> &outputs) const
 {
-  // check existence of path
-  if ( ! exists(path) )
-    throw std::runtime_error("HDF5pp::read: dataset not found ('"+path+"')");
+  if ( paths.size() != outputs.size() )
+    throw std::runtime_error("HDF5pp::Ensemble: number of paths and outputs inconsistent");
 
-  // open dataset
-  H5::DataSet dataset = m_file.openDataSet(path.c_str());
+  // resize outputs if needed
+  std::vector<T*> data;
 
-  // allocate output
-  T data = T::from_shape(this->shape(dataset));
+  for ( size_t j = 0 ; j < paths.size() ; ++j )
+  {
+    std::vector<size_t> shape = this->shape(paths[j]);
 
-  // read data
-  dataset.read(data.begin(), HT);
+    xt::xarray<T> &output = *outputs[j];
 
-  // return output
-  return data;
-}
+    if ( output.dimension() != shape.size() ||
+         !std::equal(shape.begin(), shape.end(), output.shape().begin()) )
+      output.resize(shape);
 
-// -------------------------------------------------------------------------------------------------
+    data.push_back(output.data());
+  }
+
+  // read data
+  read(paths, data);
+}
 
 #endif
 